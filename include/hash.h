@@ -0,0 +1,105 @@
+#ifndef HASH_T
+#define HASH_T
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/*-------------------------------------------------------------------------------------------------------------------------------------------------
+ * Content Hashing
+ * ~ ~ Fast non-cryptographic hashes used to fingerprint archive entries. Equal hashes only mean "probably equal"; anything that acts on a
+ *     match (deduplication, diffing) confirms it with a byte compare.
+ -------------------------------------------------------------------------------------------------------------------------------------------------*/
+namespace hash
+{
+	namespace detail
+	{
+		static inline const uint64_t PRIME64_1{ 0x9E3779B185EBCA87ULL };
+		static inline const uint64_t PRIME64_2{ 0xC2B2AE3D27D4EB4FULL };
+		static inline const uint64_t PRIME64_3{ 0x165667B19E3779F9ULL };
+		static inline const uint64_t PRIME64_4{ 0x85EBCA77C2B2AE63ULL };
+		static inline const uint64_t PRIME64_5{ 0x27D4EB2F165667C5ULL };
+
+		template <class scalar_t>
+		inline scalar_t readLE(const std::byte* data)									// Unaligned little endian load
+		{
+			scalar_t value;
+			std::memcpy(&value, data, sizeof(scalar_t));
+			if constexpr (std::endian::native == std::endian::big)
+			{
+				scalar_t swapped{};
+				for (size_t i = 0; i < sizeof(scalar_t); i++)
+					swapped |= ((value >> (i * 8)) & 0xff) << ((sizeof(scalar_t) - 1 - i) * 8);
+				value = swapped;
+			}
+			return value;
+		}
+
+		inline uint64_t round(uint64_t accumulator, const uint64_t& input)
+		{
+			accumulator += input * PRIME64_2;
+			accumulator  = std::rotl(accumulator, 31);
+			return accumulator * PRIME64_1;
+		}
+
+		inline uint64_t merge(uint64_t accumulator, const uint64_t& value)
+		{
+			accumulator ^= round(0, value);
+			return accumulator * PRIME64_1 + PRIME64_4;
+		}
+	}
+
+	/* xxh64
+	*  XXH64 over a contiguous block. The four independent lanes keep the multipliers pipelined (and let the compiler vectorize the
+	*  stripe loop), so this runs at memory bandwidth on mapped data.
+	*/
+	inline uint64_t xxh64(const std::byte* data, const size_t& length, const uint64_t& seed = 0)
+	{
+		using namespace detail;
+
+		const std::byte* cursor = data;
+		const std::byte* end	= data + length;
+		uint64_t result;
+
+		if (length >= 32)
+		{
+			uint64_t lanes[4]{ seed + PRIME64_1 + PRIME64_2, seed + PRIME64_2, seed, seed - PRIME64_1 };
+			for (; cursor + 32 <= end; cursor += 32)
+				for (int lane = 0; lane < 4; lane++)
+					lanes[lane] = round(lanes[lane], readLE<uint64_t>(cursor + lane * 8));
+
+			result = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) + std::rotl(lanes[3], 18);
+			for (const uint64_t& lane : lanes)
+				result = merge(result, lane);
+		}
+		else
+			result = seed + PRIME64_5;
+
+		result += static_cast<uint64_t>(length);
+
+		for (; cursor + 8 <= end; cursor += 8)
+		{
+			result ^= round(0, readLE<uint64_t>(cursor));
+			result  = std::rotl(result, 27) * PRIME64_1 + PRIME64_4;
+		}
+		if (cursor + 4 <= end)
+		{
+			result ^= static_cast<uint64_t>(readLE<uint32_t>(cursor)) * PRIME64_1;
+			result  = std::rotl(result, 23) * PRIME64_2 + PRIME64_3;
+			cursor += 4;
+		}
+		for (; cursor < end; cursor++)
+		{
+			result ^= static_cast<uint64_t>(*cursor) * PRIME64_5;
+			result  = std::rotl(result, 11) * PRIME64_1;
+		}
+
+		result ^= result >> 33; result *= PRIME64_2;
+		result ^= result >> 29; result *= PRIME64_3;
+		result ^= result >> 32;
+		return result;
+	}
+}
+
+#endif // !HASH_T
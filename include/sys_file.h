@@ -0,0 +1,108 @@
+#ifndef SYS_FILE
+#define SYS_FILE
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <span>
+#include <utility>
+
+using ByteView = std::span<const std::byte>;			// Non-owning view over a mapping or a ByteArray
+
+/*-------------------------------------------------------------------------------------------------------------------------------------------------
+ * MappedFile
+ * ~ ~ Read only memory mapping of a file on disk. Nothing is read up front; pages are only faulted in once a view into them is touched.
+ *     Native handles are kept opaque so platform headers stay out of every translation unit. (Defined in src/io/sys_file.cpp)
+ -------------------------------------------------------------------------------------------------------------------------------------------------*/
+class MappedFile
+{
+	const std::byte* begin{};
+	size_t			 length{};
+	void*			 mapping{};								// Mapping object handle. Only used on windows
+	bool			 opened{};								// Empty files are open but have nothing mapped
+
+public:
+	MappedFile() = default;
+	MappedFile(const std::string& path) { open(path); }
+	~MappedFile() { close(); }
+
+	MappedFile(const MappedFile&)			 = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&& rhs) noexcept				{ *this = std::move(rhs); }
+	MappedFile& operator=(MappedFile&& rhs) noexcept
+	{
+		if (this == &rhs) return *this;
+		close();
+		begin   = rhs.begin;   rhs.begin   = nullptr;
+		length  = rhs.length;  rhs.length  = 0;
+		mapping = rhs.mapping; rhs.mapping = nullptr;
+		opened  = rhs.opened;  rhs.opened  = false;
+		return *this;
+	}
+
+	bool open(const std::string& path);						// Returns false if the file could not be opened or mapped
+	void close();
+
+	bool			 is_open() const { return opened; }
+	const std::byte* data()    const { return begin; }
+	size_t			 size()    const { return length; }
+
+	/* view
+	*  Returns the bytes in [offset, offset + count). Ranges exceeding the mapping return an empty view.
+	*/
+	ByteView view(const size_t& offset, const size_t& count) const
+	{
+		if (offset > length || count > length - offset) return {};
+		return { begin + offset, count };
+	}
+};
+
+/*-------------------------------------------------------------------------------------------------------------------------------------------------
+ * NativeFile
+ * ~ ~ Thin wrapper over an OS file handle for positional reads and writes. Positional calls never touch a shared file cursor, so a single
+ *     handle can be used by every thread in a pool at once. (Defined in src/io/sys_file.cpp)
+ -------------------------------------------------------------------------------------------------------------------------------------------------*/
+class NativeFile
+{
+	intptr_t handle{ -1 };									// File descriptor, or HANDLE on windows
+
+public:
+	enum class Mode
+	{
+		READ,												// Open an existing file for reading
+		WRITE,												// Create (or truncate) a file for writing
+		MODIFY												// Open an existing file for reading and writing in place
+	};
+
+	NativeFile() = default;
+	NativeFile(const std::string& path, const Mode& mode = Mode::READ) { open(path, mode); }
+	~NativeFile() { close(); }
+
+	NativeFile(const NativeFile&)			 = delete;
+	NativeFile& operator=(const NativeFile&) = delete;
+	NativeFile(NativeFile&& rhs) noexcept				{ *this = std::move(rhs); }
+	NativeFile& operator=(NativeFile&& rhs) noexcept
+	{
+		if (this == &rhs) return *this;
+		close();
+		handle = rhs.handle; rhs.handle = -1;
+		return *this;
+	}
+
+	bool open(const std::string& path, const Mode& mode = Mode::READ);
+	void close();
+
+	bool	 is_open() const { return handle != -1; }
+	uint64_t size()    const;
+
+	bool read (const uint64_t& offset, void* buffer, const size_t& count) const;			// Returns false on a short read
+	bool write(const uint64_t& offset, const void* buffer, const size_t& count) const;		// Returns false on a short write
+
+	/* copy
+	*  Copy count bytes between two files without staging them in a user space buffer where the OS allows it
+	*  (copy_file_range, then sendfile). Falls back to positional reads and writes through a small fixed buffer.
+	*/
+	static bool copy(const NativeFile& source, uint64_t source_offset, const NativeFile& destination, uint64_t destination_offset, uint64_t count);
+};
+
+#endif // !SYS_FILE
@@ -53,6 +53,13 @@ namespace Interface
 			return args[index];
 		}
 
+		std::optional<const std::string> getSwitch(const std::string& search_switch) const noexcept
+		{
+			for (const Switch& sw : switches)
+				if (sw.text == search_switch) return sw.parameter;
+			return std::nullopt;
+		}
+
 		const size_t argc() const noexcept
 		{
 			return args.size();
@@ -1,6 +1,8 @@
 #pragma once
 #include <string>
 #include "structures/afs.h"
+#include "structures/afstoc.h"
+#include "structures/afsmanifest.h"
 #include "interface/log.h"
 #include "interface/argParser.h"
 
@@ -10,17 +12,71 @@ namespace Interface
 	{
 
 		static inline const std::string AfsExtract_help_text{
-			"afs-extract [file.afs] <output directory>\n"
-			"Extracts The Contents Of An AFS File Into A Directory.\n\n"
+			"afs-extract [file.afs] <output directory> (names...)\n"
+			"Extracts The Contents Of An AFS File Into A Directory. (threaded)\n"
+			"Optionally Only Extract The Named Entries. Names May Use * And ? Wildcards.\n\n"
 			"Flags:\n"
-			"\t-i\tIgnore Empty Entries.\n"
+			"\t-i\t\tIgnore Empty Entries.\n"
+			"\t/list <file>\tExtract Every Name Listed In A Text File. (One Per Line)\n"
+		};
+		static inline const std::string AfsList_help_text{
+			"afs-list [file.afs] (file.afs)...\n"
+			"afs-list -r <directory>\n"
+			"Lists The Entries Of AFS Files Without Reading Their Contents.\n\n"
+			"Flags:\n"
+			"\t-r <dir>\tRecursively Search A Directory For AFS Files And List Them.\n"
+			"\t-csv\t\tMachine Readable Output. (archive,index,offset,size,name)\n"
+		};
+		static inline const std::string AfsPatch_help_text{
+			"afs-patch [file.afs] [entry name] [replacement file] (entry name) (replacement file)...\n"
+			"Replaces Entries Of An AFS File In Place Without Rebuilding It.\n"
+			"Entries That Outgrow Their Slot Are Moved To The End Of The Archive.\n"
+		};
+		static inline const std::string AfsDiff_help_text{
+			"afs-diff [old.afs] [new.afs]\n"
+			"Compares Two AFS Files Entry By Entry Without Extracting Them. (threaded)\n"
+			"Entries Are Matched By Their AFS Info Path, Or File Table Name.\n\n"
+			"Flags:\n"
+			"\t-csv\t\tMachine Readable Output. (status,name,old offset,old size,new offset,new size,first changed byte,last changed byte)\n"
+		};
+		static inline const std::string AfsManifest_help_text{
+			"afs-manifest [file.afs] (manifest)\n"
+			"afs-manifest -r <directory>\n"
+			"Writes The Offset, Size And xxh64 Of Every Entry Of An AFS File. (threaded)\n"
+			"The Manifest Defaults To [file.afs].manifest\n\n"
+			"Flags:\n"
+			"\t-r <dir>\tRecursively Search A Directory For AFS Files And Write A Manifest Beside Each.\n"
+		};
+		static inline const std::string AfsVerify_help_text{
+			"afs-verify [file.afs] (manifest)\n"
+			"afs-verify [directory] [manifest]\n"
+			"afs-verify -r <directory>\n"
+			"Checks An AFS File, Or A Directory It Was Extracted To, Against A Manifest. (threaded)\n"
+			"Every Entry That Does Not Match Is Listed.\n\n"
+			"Flags:\n"
+			"\t-r <dir>\tRecursively Verify Every AFS File That Has A Manifest Beside It.\n"
 		};
 		static inline const std::string AfsBuild_help_text{
 			"afs-build <content directory> [output.afs]\n"
-			"Build An AFS File From The Contents Of A Directory.\n"
+			"Build An AFS File From The Contents Of A Directory.\n\n"
+			"Flags:\n"
+			"\t-dedupe\t\tStore Files With Identical Contents Once. (threaded)\n"
+			"\t/trace <file>\tLay Files Out In The Order They Are Loaded. (One Index Or Name Per Line)\n"
+			"\t\t\tThe TOC Order Is Kept. Reports The Change In Seeks.\n"
 		};
 
 		void AfsExtract(const ArgParser& parser, const Log& output);
 		void AfsBuild(const ArgParser& parser, const Log& output);
+		void AfsPatch(const ArgParser& parser, const Log& output);
+		void AfsList(const ArgParser& parser, const Log& output);
+		void AfsDiff(const ArgParser& parser, const Log& output);
+		void AfsManifest(const ArgParser& parser, const Log& output);
+		void AfsVerify(const ArgParser& parser, const Log& output);
+
+		void DoList(const std::filesystem::path& filepath, const bool& csv, const Log& output);
+		std::pair<size_t, size_t> ChangedRange(ByteView lhs, ByteView rhs);
+		bool DoManifest(const std::string& filepath, const std::string& manifest, const Log& output);
+		bool DoVerify(const std::string& target, const std::string& manifest, const Log& output);
+		std::vector<std::filesystem::path> FindArchives(const std::string& directory);
 	}
 }
@@ -2,11 +2,17 @@
 
 #include <string>
 #include "structures/dat.h"
+#include "structures/tpl.h"
+#include "structures/smd.h"
+#include "structures/etm.h"
+#include "structures/itm.h"
 #include "interface/log.h"
 #include "interface/argParser.h"
 #include "thread_pool.hpp"
 #include "interface/common.h"
 
+#include <mutex>
+
 namespace Interface
 {
 	namespace DAT
@@ -17,17 +23,63 @@ namespace Interface
 			"Extracts The Contents Of A DAT File Into A Directory.\n"
 			"Optionally You Can Extract All DAT Files In A Directory With The -r Flag.\n\n"
 			"Flags:\n"
-			"\t-r <dir>\tRecursively Search A Directory For DAT Files And Extract Them. (threaded)\n"
+			"\t-r <dir>\tRecursively Search A Directory For DAT Files And Extract Them.\n\n"
+			"Switches:\n"
+			"\t/type <list>\tOnly Extract Segments Of These Formats. (Eg TPL,SMD)\n"
+			"\t/exclude <list>\tSkip Segments Of These Formats. Dummy Segments Are DMY.\n"
+			"\t/index <ranges>\tOnly Extract Segments In These Index Ranges. (Eg 0-10,15,20-)\n\n"
+			"Filters Are Checked Against The Header, So Skipped Segments Are Never Read.\n"
+			"Segments Are Written In Parallel, Including Within Each File Of A Recursive Run. (threaded)\n"
 		};
 		static inline const std::string DatBuild_help_text{
-			"\ndat-build <directory> [file.dat]\n\n"
+			"\ndat-build <directory> [file.dat]\n"
+			"dat-build -r <directory>\n\n"
 			"Builds A DAT File From The Contents Of A Directory.\n"
-			"Filenames MUST Be Numbers, And The Extension Must Be The Format Type. (Eg 0.EFF, 1.TPL, 3.BIN)\n"
+			"Filenames MUST Be Numbers, And The Extension Must Be The Format Type. (Eg 0.EFF, 1.TPL, 3.BIN)\n\n"
+			"Flags:\n"
+			"\t-r <dir>\tRecursively Search A Directory For '<name>-dat' Folders And Rebuild Each As '<name>.dat' Beside It. (threaded)\n"
+			"\t\t\tNested Folders Are Rebuilt Before The Folders That Contain Them.\n"
+		};
+
+		static inline const std::string DeepExtract_help_text{
+			"\ndeep-extract [file] <output directory>\n"
+			"deep-extract -r <directory>\n\n"
+			"Extracts A DAT, TPL, SMD, ETM Or ITM File And Everything Nested Inside It In One Pass. (threaded)\n"
+			"Segments Are Parsed In Memory By Their Format And TPLs Are Written Straight To TGA. No Intermediate Files Are Written.\n\n"
+			"Flags:\n"
+			"\t-r <dir>\tRecursively Search A Directory For DAT Files And Deep Extract Them.\n"
+		};
+
+		/* DeepExtraction
+		*  State shared by one deep-extract run. Every payload is a task on the same pool, and nested payloads are views into the root mapping,
+		*  so nothing is copied or written to disk until a parser produces its final output.
+		*/
+		struct DeepExtraction
+		{
+			const Log&				 output;
+			std::mutex				 lock;
+			std::vector<std::string> failures;
+			thread_pool				 pool;				// Declared last so it is torn down before the state its tasks use
+
+			DeepExtraction(const Log& log) : output(log) {}
+
+			static bool supports(const std::string& format);
+
+			void schedule(ByteView data, const std::string& format, const std::filesystem::path& outpath);
+			void extract(ByteView data, const std::string& format, const std::filesystem::path& outpath);
+			template<class dat_t> void extractDat(ByteView data, const std::filesystem::path& outpath);
 		};
 
 		void DatExtract(const ArgParser& parser, const Log& output);
 		void DatBuild(const ArgParser& parser, const Log& output);
+		void DeepExtract(const ArgParser& parser, const Log& output);
+
+		void RecursiveDatExtract(const ArgParser& parser, const Log& output, const dat::SegmentFilter& filter = {});
+		void RecursiveDatBuild(const ArgParser& parser, const Log& output);
+
+		bool ParseSegmentFilter(const ArgParser& parser, dat::SegmentFilter& filter, const Log& output);
 
-		void DoExtraction(const std::filesystem::path& filepath, const std::filesystem::path& outpath, const Log& output);
+		void DoExtraction(const std::filesystem::path& filepath, const std::filesystem::path& outpath, const Log& output, const dat::SegmentFilter& filter = {});
+		void DoExtraction(const std::filesystem::path& filepath, const std::filesystem::path& outpath, const Log& output, thread_pool& pool, const dat::SegmentFilter& filter = {});
 	}
 }
@@ -13,11 +13,52 @@ namespace Interface
 		static inline const std::string TplMerge_help_text{};
 		static inline const std::string TplExtract_help_text{};
 		static inline const std::string TplDecompile_help_text{};
+		static inline const std::string TplCompile_help_text{
+			"\ntpl-compile [output.tpl] <images dir>\n\n"
+			"Compiles Numbered TGA Images (Eg 0.tga, 1.tga) Into A TPL File, As Written By tpl-decompile. (threaded)\n"
+			"Colours Are Quantized To A 256 Colour Palette Unless Another Format Is Requested.\n\n"
+			"Flags:\n"
+			"\t-4bit\t\tQuantize To A 16 Colour Palette.\n"
+			"\t-32bit\t\tStore Colours Directly Without A Palette.\n"
+			"\t-dither\t\tDiffuse Quantization Error Across Neighbouring Pixels.\n"
+			"\t-swizzle\tStore Textures PS2 Interlaced, Swizzled For GS Memory.\n"
+		};
+
+		static inline const std::string TplRequantize_help_text{
+			"\ntpl-requantize [file.tpl] <output.tpl>\n"
+			"tpl-requantize -r <directory>\n\n"
+			"Converts 32-bit TPL Textures To A 256 Colour Palette, Overwriting The File Unless An Output Is Given. (threaded)\n"
+			"Textures That Would Fall Below The Quality Threshold Are Kept As They Are. Mipmaps Share Their Texture's Palette.\n\n"
+			"Flags:\n"
+			"\t-r <dir>\tRecursively Search A Directory For TPL Files And Requantize Them In Place.\n"
+			"\t-4bit\t\tQuantize To A 16 Colour Palette.\n"
+			"\t-dither\t\tDiffuse Quantization Error Across Neighbouring Pixels.\n"
+			"\t-swizzle\tStore Textures PS2 Interlaced, Swizzled For GS Memory.\n\n"
+			"Switches:\n"
+			"\t/index <ranges>\tOnly Convert Entries In These Index Ranges. (Eg 0-10,15,20-)\n"
+			"\t/psnr <dB>\tMinimum Quality To Accept A Conversion. (Default 30)\n"
+		};
+
+		/* RequantizeOptions
+		*  Settings shared by every file of a tpl-requantize run. maxError is the mean per pixel error matching the requested PSNR.
+		*/
+		struct RequantizeOptions
+		{
+			tpl::CompileOptions					   compile{};
+			double								   maxError{};
+			std::vector<std::pair<size_t, size_t>> ranges{};
+		};
 
 		void TplBuild(const ArgParser& parser, const Log& output);
 		void TplMerge(const ArgParser& parser, const Log& output);
 		void TplExtract(const ArgParser& parser, const Log& output);
 		void TplDecompile(const ArgParser& parser, const Log& output);
+		void TplCompile(const ArgParser& parser, const Log& output);
+		void TplRequantize(const ArgParser& parser, const Log& output);
+
+		bool ParseRequantizeOptions(const ArgParser& parser, RequantizeOptions& options, const Log& output);
+		void RecursiveRequantize(const ArgParser& parser, const Log& output, const RequantizeOptions& options);
+		std::vector<tpl::Requantization> DoRequantize(const std::filesystem::path& filepath, const std::filesystem::path& outpath, const RequantizeOptions& options, thread_pool& pool, const Log& output);
 
 		void DoDecompile(const std::filesystem::path& filepath, const std::filesystem::path& outpath, const Log& output);
 	}
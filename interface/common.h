@@ -2,8 +2,14 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <algorithm>
 #include <filesystem>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <exception>
 
 #include "interface/log.h"
 #include "tga.h"
@@ -24,6 +30,28 @@ static inline std::ostream& operator<< (std::ostream& stream, tga::Header& rhs)
 
 namespace Interface
 {
+	/* NumericFile
+	*  A file in a directory whose stems are sequential indices (0.TPL, 1.BIN, ...), as collected by scanNumericDirectory.
+	*/
+	struct NumericFile
+	{
+		size_t		index{};
+		uint64_t	size{};
+		std::string extension{};
+		std::string path{};
+	};
+
+	/* scanNumericDirectory
+	*  Lists a directory in a single pass, recording the index, extension and size of every file with a numeric stem, sorted by index.
+	*  Other files are skipped. If two files share an index, the first by name is kept.
+	*/
+	std::vector<NumericFile> scanNumericDirectory(const std::string& path);
+
+	/* parseIndexRanges
+	*  Parses a comma separated list of inclusive index ranges (Eg 0-10,15,20-). An open end runs to SIZE_MAX. Returns false if an item is invalid.
+	*/
+	bool parseIndexRanges(const std::string& list, std::vector<std::pair<size_t, size_t>>& ranges);
+
 	std::vector<std::string> getSequentialNumericFilenames(const std::string& path);
 	size_t					 getHighestFileNumber		  (const std::string& path);
 
@@ -71,6 +99,7 @@ namespace Interface
 	void createSavePath(const std::string& path);
 
 	const std::string& to_lower(std::string&);
+	bool matchWildcard(std::string_view pattern, std::string_view text);
 	
 	template<class numeric_t>
 	static inline std::string to_hex(const numeric_t& value)
@@ -97,6 +126,52 @@ namespace Interface
 		return ret;
 	}
 	
+	/* ParallelFor
+	*  Runs body(i) for every i in [0, count) across the pool. The calling thread works through the range as well and only waits on helpers
+	*  that are part way through an item, so it is safe to call from a task already running on the same pool without oversubscribing it.
+	*  The wait blocks until the last helper finishes. The first exception thrown by body stops the remaining items and is rethrown here.
+	*/
+	template<class Body>
+	static void ParallelFor(thread_pool& pool, const size_t& count, Body body)
+	{
+		struct State
+		{
+			std::atomic<size_t> next{ 0 }, active{ 0 };
+			size_t				count;
+			Body				body;
+			std::mutex			error_mutex;
+			std::exception_ptr	error;
+			State(const size_t& n, Body&& b) : count(n), body(std::move(b)) {}
+
+			void run()
+			{
+				++active;
+				try
+				{
+					for (size_t i = next++; i < count; i = next++)
+						body(i);
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lock(error_mutex);
+					if (!error) error = std::current_exception();
+					next = count;
+				}
+				if (--active == 0) active.notify_all();
+			}
+		};
+
+		auto state = std::make_shared<State>(count, std::move(body));
+		size_t helpers = std::min<size_t>(count, pool.get_thread_count()) - (count != 0);
+		for (size_t i = 0; i < helpers; i++)
+			pool.push_task([state] { state->run(); });			// Helpers that start late find the range empty and return
+
+		state->run();
+		for (size_t active = state->active; active; active = state->active)
+			state->active.wait(active);
+		if (state->error) std::rethrow_exception(state->error);
+	}
+
 	static void RecursiveExtract(const ArgParser& parser, const Log& output, const std::string& extension, void (*Extraction)(const std::filesystem::path&, const std::filesystem::path&, const Log&))
 	{
 		thread_pool pool;
@@ -115,7 +190,7 @@ namespace Interface
 			if (!std::filesystem::is_regular_file(file)) continue;
 			if (StringToLower(file.path().extension().string()) != StringToLower(extension)) continue;
 
-			pool.submit(Extraction, file.path(), file.path().parent_path().string() + "/" + file.path().filename().stem().string() + "-" + StringToLower(extension.substr(1)), output);
+			pool.submit(Extraction, file.path(), file.path().parent_path().string() + "/" + file.path().filename().stem().string() + "-" + StringToLower(extension.substr(1)), std::cref(output));
 		}
 
 		pool.wait_for_tasks();
@@ -22,12 +22,20 @@ namespace Interface
 		static inline std::map<std::string, cmd> commands{
 			{ "afs-extract",	 Interface::AFS::AfsExtract },
 			{ "afs-build",		 Interface::AFS::AfsBuild },
+			{ "afs-patch",		 Interface::AFS::AfsPatch },
+			{ "afs-list",		 Interface::AFS::AfsList },
+			{ "afs-diff",		 Interface::AFS::AfsDiff },
+			{ "afs-manifest",	 Interface::AFS::AfsManifest },
+			{ "afs-verify",		 Interface::AFS::AfsVerify },
 			{ "dat-extract",	 Interface::DAT::DatExtract },
 			{ "dat-build",		 Interface::DAT::DatBuild },
+			{ "deep-extract",	 Interface::DAT::DeepExtract },
 			{ "tpl-build",		 Interface::TPL::TplBuild },
 			{ "tpl-merge",		 Interface::TPL::TplMerge },
 			{ "tpl-extract",	 Interface::TPL::TplExtract },
 			{ "tpl-decompile",	 Interface::TPL::TplDecompile },
+			{ "tpl-compile",	 Interface::TPL::TplCompile },
+			{ "tpl-requantize",	 Interface::TPL::TplRequantize },
 			{ "smd-extract",	 Interface::SMD::SmdExtract },
 			{ "smd-bin-extract", Interface::SMD::SmdBinExtract },
 			{ "smd-tpl-extract", Interface::SMD::SmdTplExtract },
@@ -55,14 +63,22 @@ namespace Interface
 			"Available Commands:\n"
 			"afs-extract\t[file.afs] <outdir>\t\t\tExtract An AFS File Into Specified Directory\n"
 			"afs-build\t<files dir> [file.afs]\t\t\tBuild An AFS File From Specified Directory\n"
+			"afs-patch\t[file.afs] [name] [file]\t\t\tReplace AFS Entries In Place\n"
+			"afs-list\t[file.afs] (file.afs)...\t\t\tList AFS Entries Without Reading Them\n"
+			"afs-diff\t[old.afs] [new.afs]\t\t\tReport Added, Removed And Changed AFS Entries\n"
+			"afs-manifest\t[file.afs] (manifest)\t\t\tWrite Entry Offsets, Sizes And Hashes\n"
+			"afs-verify\t[file.afs | dir] (manifest)\t\tCheck An AFS File Or Extraction Against A Manifest\n"
 			"\n"
 			"dat-extract\t[file.dat] <outdir>\t\t\tExtract A DAT File Into Specified Directory.\n"
 			"dat-build\t<files dir> [output.dat]\t\tBuild A DAT File Using A Specified Directory\n"
+			"deep-extract\t[file] <outdir>\t\t\t\tExtract A DAT And Everything Nested In It Straight To TGA\n"
 			"\n"
 			"tpl-merge \t[output.tpl] [tpl_1.tpl] [tpl_n.tpl]\tMerge TPL Files Together.\n"
 			"tpl-extract \t[file.tpl] <outdir>\t\t\tExtract TPL File Into Specified Directory.\n"
 			//"tpl-build \t<images dir> (format) [output.tpl]\tBuild TPL File From TGA Images. Formats: 4-bit, 8-bit, 32-bit\n"
 			"tpl-decompile \t[file.tpl] <outdir>\t\t\tConvert TPL entries into TGA Files and Save.\n"
+			"tpl-compile \t[output.tpl] <images dir>\t\tBuild A TPL File From TGA Images. Formats: 4-bit, 8-bit, 32-bit\n"
+			"tpl-requantize \t[file.tpl] <output.tpl>\t\t\tConvert 32-bit TPL Textures To 8-bit Or 4-bit Palettes.\n"
 			"\n"
 			"smd-extract\t[file.smd] <outdir>\t\t\tExtract TPL and BIN Files From SMD\n"
 			"smd-bin-extract\t[file.smd] <outdir>\t\t\tExtract BIN Files From SMD\n"
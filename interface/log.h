@@ -6,6 +6,7 @@
 #include <vector>
 #include <iostream>
 #include <filesystem>
+#include <mutex>
 
 #define EXCEPT_TEXT(x) std::filesystem::path(__FILE__).filename().string() + "[" + std::to_string(__LINE__) + "] \n\tREASON: " + x
 
@@ -51,6 +52,7 @@ namespace Interface
         std::vector<OutputWrapper*> probes{};
 
         mutable std::vector<std::string> history;
+        mutable std::recursive_mutex lock;        // Pool workers log through the same instance. Recursive as saveHistory can log
     public:
         ~Log();
         void setLevel(const Level&) const;
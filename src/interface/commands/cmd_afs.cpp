@@ -17,9 +17,297 @@ namespace Interface
 			if (!std::filesystem::exists(filepath)) { output.log(Level::ERROR, "Unable To Locate Requested File!"); return; }
 
 			output.log(Level::LOG, "Loading AFS File: " + filepath + "\n");
-			afs::AfsFile afsFile(filepath, output);
+			afs::AfsFile afsFile(output);
+			if (!afsFile.mapFromFile(filepath)) { output.log(Level::ERROR, "Unable To Open Requested File. Unknown Format!"); return; }
+
+			std::vector<std::string> names;
+			if (parser.argc() > 2)
+				for (const auto& name : parser.getArgs(2))
+					names.push_back(name);
+			if (auto list = parser.getSwitch("list"))
+			{
+				std::ifstream stream(*list);
+				if (!stream.is_open()) { output.log(Level::ERROR, "Unable To Open Name List: " + *list); return; }
+				for (std::string line; std::getline(stream, line);)
+				{
+					line = line.substr(0, line.find_last_not_of("\r ") + 1);
+					if (!line.empty()) names.push_back(line);
+				}
+			}
+
 			output.log(Level::LOG, "Extracting AFS To: " + outpath + "\n");
-			afsFile.extractAll(outpath, parser.hasFlag("i"));
+			if (names.empty())
+				afsFile.extractAll(outpath, parser.hasFlag("i"));
+			else
+				afsFile.extract(afsFile.resolveNames(names), outpath, parser.hasFlag("i"));
+		}
+
+		void AfsList(const ArgParser& parser, const Log& output)
+		{
+			bool csv = parser.hasFlag("csv");
+
+			if (parser.hasFlag("r") || parser.hasFlag("recursive"))
+			{
+				for (const auto& file : FindArchives(parser.argc() ? *parser.arg(0) : std::filesystem::current_path().string()))
+					DoList(file, csv, output);
+				return;
+			}
+
+			if (parser.argc() < 1)
+			{
+				output.log(Level::ERROR, AfsList_help_text);
+				return;
+			}
+
+			for (const auto& filepath : parser.getArgs())
+				DoList(filepath, csv, output);
+		}
+
+		std::vector<std::filesystem::path> FindArchives(const std::string& directory)
+		{
+			std::vector<std::filesystem::path> archives;
+			for (auto& file : std::filesystem::recursive_directory_iterator(directory))
+			{
+				if (!std::filesystem::is_regular_file(file)) continue;
+				if (StringToLower(file.path().extension().string()) != ".afs") continue;
+				archives.push_back(file.path());
+			}
+			return archives;
+		}
+
+		void AfsManifest(const ArgParser& parser, const Log& output)
+		{
+			if (parser.hasFlag("r") || parser.hasFlag("recursive"))
+			{
+				for (const auto& file : FindArchives(parser.argc() ? *parser.arg(0) : std::filesystem::current_path().string()))
+					DoManifest(file.string(), file.string() + ".manifest", output);
+				return;
+			}
+
+			if (parser.argc() < 1)
+			{
+				output.log(Level::ERROR, AfsManifest_help_text);
+				return;
+			}
+
+			std::string filepath{ *parser.arg(0) };
+			DoManifest(filepath, parser.argc() > 1 ? *parser.arg(1) : filepath + ".manifest", output);
+		}
+
+		bool DoManifest(const std::string& filepath, const std::string& manifest, const Log& output)
+		{
+			afs::AfsFile afsFile(output);
+			if (!afsFile.mapFromFile(filepath)) { output.log(Level::ERROR, "Unable To Open Requested File: " + filepath); return false; }
+
+			afs::AfsManifest entries(output);
+			entries.build(afsFile);
+			if (!entries.save(manifest)) { output.log(Level::ERROR, "Unable To Write Manifest: " + manifest); return false; }
+
+			output.log(Level::LOG, "Wrote " + std::to_string(entries.size()) + " Entries To: " + manifest);
+			return true;
+		}
+
+		void AfsVerify(const ArgParser& parser, const Log& output)
+		{
+			if (parser.hasFlag("r") || parser.hasFlag("recursive"))
+			{
+				size_t passed{}, failed{};
+				for (const auto& file : FindArchives(parser.argc() ? *parser.arg(0) : std::filesystem::current_path().string()))
+				{
+					std::string manifest = file.string() + ".manifest";
+					if (!std::filesystem::is_regular_file(manifest)) continue;
+					DoVerify(file.string(), manifest, output) ? passed++ : failed++;
+				}
+				output.log(Level::LOG, "\n" + std::to_string(passed) + " Archives Passed, " + std::to_string(failed) + " Failed");
+				return;
+			}
+
+			if (parser.argc() < 1)
+			{
+				output.log(Level::ERROR, AfsVerify_help_text);
+				return;
+			}
+
+			std::string target{ *parser.arg(0) };
+			if (std::filesystem::is_directory(target) && parser.argc() < 2)
+			{
+				output.log(Level::ERROR, "A Manifest Is Required To Verify A Directory!");
+				return;
+			}
+			DoVerify(target, parser.argc() > 1 ? *parser.arg(1) : target + ".manifest", output);
+		}
+
+		bool DoVerify(const std::string& target, const std::string& manifest, const Log& output)
+		{
+			afs::AfsManifest entries(output);
+			if (!entries.load(manifest)) { output.log(Level::ERROR, "Unable To Load Manifest: " + manifest); return false; }
+
+			std::vector<afs::AfsManifest::Failure> failures;
+			if (std::filesystem::is_directory(target))
+				failures = entries.verify(target);
+			else
+			{
+				afs::AfsFile afsFile(output);
+				if (!afsFile.mapFromFile(target)) { output.log(Level::ERROR, "Unable To Open Requested File: " + target); return false; }
+				failures = entries.verify(afsFile);
+			}
+
+			for (const auto& failure : failures)
+			{
+				std::string name = failure.index < entries.size() ? entries[failure.index].name : "";
+				output.log(Level::ERROR, "\t" + std::to_string(failure.index) + "\t" + name + "\t" + failure.reason);
+			}
+
+			if (failures.empty()) output.log(Level::LOG, target + ": OK [" + std::to_string(entries.size()) + " Entries]");
+			else				  output.log(Level::ERROR, target + ": " + std::to_string(failures.size()) + " Of " + std::to_string(entries.size()) + " Entries Failed");
+			return failures.empty();
+		}
+
+		void DoList(const std::filesystem::path& filepath, const bool& csv, const Log& output)
+		{
+			afs::AfsToc toc(output);
+			if (!toc.load(filepath.string())) { output.log(Level::ERROR, "Unable To Open Requested File: " + filepath.string()); return; }
+
+			if (!csv) output.log(Level::LOG, filepath.string() + " [" + std::to_string(toc.size()) + " Entries]");
+			for (size_t i = 0; i < toc.size(); i++)
+			{
+				if (csv)
+					output.log(Level::LOG, filepath.string() + "," + std::to_string(i) + "," + std::to_string(toc.offset(i)) + "," + std::to_string(toc.entrySize(i)) + "," + std::string(toc.name(i)));
+				else
+					output.log(Level::LOG, "\t" + std::to_string(i) + "\t" + to_hex(toc.offset(i)) + "\t" + std::to_string(toc.entrySize(i)) + "\t" + std::string(toc.name(i)));
+			}
+		}
+
+		void AfsDiff(const ArgParser& parser, const Log& output)
+		{
+			if (parser.argc() < 2)
+			{
+				output.log(Level::ERROR, AfsDiff_help_text);
+				return;
+			}
+
+			std::string oldpath{ *parser.arg(0) }, newpath{ *parser.arg(1) };
+			bool csv = parser.hasFlag("csv");
+
+			if (!std::filesystem::exists(oldpath)) { output.log(Level::ERROR, "Unable To Locate Requested File: " + oldpath); return; }
+			if (!std::filesystem::exists(newpath)) { output.log(Level::ERROR, "Unable To Locate Requested File: " + newpath); return; }
+
+			afs::AfsFile before(output), after(output);
+			if (!before.mapFromFile(oldpath)) { output.log(Level::ERROR, "Unable To Open Requested File. Unknown Format: " + oldpath); return; }
+			if (!after.mapFromFile(newpath))  { output.log(Level::ERROR, "Unable To Open Requested File. Unknown Format: " + newpath); return; }
+
+			// Both archives share one pool so their reads overlap
+			output.log(Level::LOG, "Hashing " + std::to_string(before.size() + after.size()) + " Entries\n");
+			std::vector<uint64_t> old_hashes, new_hashes;
+			{
+				thread_pool pool;
+				before.hashEntries(pool, old_hashes);
+				after.hashEntries(pool, new_hashes);
+				pool.wait_for_tasks();
+			}
+
+			// Repeated names are numbered by occurrence so they pair up in archive order
+			auto keyEntries = [](afs::AfsFile& file)
+			{
+				std::unordered_map<std::string, size_t> seen;
+				std::vector<std::string> keys;
+				for (size_t i = 0; i < file.size(); i++)
+				{
+					std::string name = file.entryName(i);
+					size_t occurrence = seen[name]++;
+					keys.push_back(occurrence ? name + "#" + std::to_string(occurrence) : name);
+				}
+				return keys;
+			};
+			std::vector<std::string> old_keys = keyEntries(before), new_keys = keyEntries(after);
+
+			std::unordered_map<std::string, size_t> new_index;
+			for (size_t i = 0; i < new_keys.size(); i++)
+				new_index.emplace(new_keys[i], i);
+
+			auto describe = [](afs::AfsFile& file, const size_t& index)
+			{
+				return to_hex(file.entryOffset(index)) + " (" + std::to_string(file.getData(index).size()) + " Bytes)";
+			};
+			auto row = [&](const std::string& status, const std::string& name, const std::string& old_range, const std::string& new_range, const std::string& changed_range)
+			{
+				output.log(Level::LOG, status + "," + name + "," + old_range + "," + new_range + "," + changed_range);
+			};
+
+			size_t added{}, removed{}, changed{}, unchanged{};
+			std::vector<char> matched(new_keys.size());
+			for (size_t i = 0; i < old_keys.size(); i++)
+			{
+				auto found = new_index.find(old_keys[i]);
+				if (found == new_index.end())
+				{
+					removed++;
+					if (csv) row("removed", old_keys[i], std::to_string(before.entryOffset(i)) + "," + std::to_string(before.getData(i).size()), ",", ",");
+					else	 output.log(Level::LOG, "- " + old_keys[i] + "\t" + describe(before, i));
+					continue;
+				}
+
+				size_t j = found->second;
+				matched[j] = true;
+				ByteView lhs = before.getData(i), rhs = after.getData(j);
+				if (lhs.size() == rhs.size() && old_hashes[i] == new_hashes[j]) { unchanged++; continue; }
+
+				changed++;
+				auto [first, last] = ChangedRange(lhs, rhs);
+				if (csv) row("changed", old_keys[i], std::to_string(before.entryOffset(i)) + "," + std::to_string(lhs.size()), std::to_string(after.entryOffset(j)) + "," + std::to_string(rhs.size()), std::to_string(first) + "," + std::to_string(last));
+				else	 output.log(Level::LOG, "~ " + old_keys[i] + "\t" + describe(before, i) + " -> " + describe(after, j) + "\tBytes " + to_hex(first) + "-" + to_hex(last));
+			}
+
+			for (size_t j = 0; j < new_keys.size(); j++)
+			{
+				if (matched[j]) continue;
+				added++;
+				if (csv) row("added", new_keys[j], ",", std::to_string(after.entryOffset(j)) + "," + std::to_string(after.getData(j).size()), ",");
+				else	 output.log(Level::LOG, "+ " + new_keys[j] + "\t" + describe(after, j));
+			}
+
+			if (!csv) output.log(Level::LOG, "\n" + std::to_string(changed) + " Changed, " + std::to_string(added) + " Added, " + std::to_string(removed) + " Removed, " + std::to_string(unchanged) + " Unchanged");
+		}
+
+		std::pair<size_t, size_t> ChangedRange(ByteView lhs, ByteView rhs)
+		{
+			// Inclusive range within the entry that covers every differing byte. A size change runs the range to the end of the longer side
+			size_t common = std::min(lhs.size(), rhs.size());
+			size_t first  = std::mismatch(lhs.begin(), lhs.begin() + common, rhs.begin()).first - lhs.begin();
+			size_t last   = std::max(lhs.size(), rhs.size());
+			if (lhs.size() == rhs.size())
+				while (last > first && lhs[last - 1] == rhs[last - 1]) last--;
+			return { first, last ? last - 1 : 0 };
+		}
+
+		void AfsPatch(const ArgParser& parser, const Log& output)
+		{
+			if (parser.argc() < 3 || parser.argc() % 2 == 0)
+			{
+				output.log(Level::ERROR, AfsPatch_help_text);
+				return;
+			}
+
+			std::string filepath{ *parser.arg(0) };
+
+			if (!std::filesystem::exists(filepath)) { output.log(Level::ERROR, "Unable To Locate Requested File!"); return; }
+
+			output.log(Level::LOG, "Loading AFS File: " + filepath + "\n");
+			afs::AfsFile afsFile(output);
+			if (!afsFile.mapFromFile(filepath)) { output.log(Level::ERROR, "Unable To Open Requested File. Unknown Format!"); return; }
+
+			std::vector<std::pair<size_t, std::string>> replacements;
+			for (size_t i = 1; i + 1 < parser.argc(); i += 2)
+			{
+				size_t index = afsFile.indexFromName(*parser.arg(i));
+				if (index >= afsFile.size()) { output.log(Level::ERROR, "No Entry Named: " + *parser.arg(i)); return; }
+				if (!std::filesystem::is_regular_file(*parser.arg(i + 1))) { output.log(Level::ERROR, "Unable To Locate Replacement: " + *parser.arg(i + 1)); return; }
+				replacements.push_back({ index, *parser.arg(i + 1) });
+			}
+
+			output.log(Level::LOG, "Patching AFS File: " + filepath + "\n");
+			if (!afsFile.patch(filepath, replacements))
+				output.log(Level::ERROR, "One Or More Entries Failed To Patch!");
 		}
 
 		void AfsBuild(const ArgParser& parser, const Log& output)
@@ -37,7 +325,7 @@ namespace Interface
 			output.log(Level::LOG, "Loading AFS File: " + filepath + "\n");
 			afs::AfsFile afsFile(output);
 			output.log(Level::LOG, "Extracting AFS To: " + outpath + "\n");
-			afsFile.buildAfs(filepath, outpath);
+			afsFile.buildAfs(filepath, outpath, parser.hasFlag("dedupe"), parser.getSwitch("trace").value_or(""));
 		}
 	}
 }
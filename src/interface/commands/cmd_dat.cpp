@@ -1,14 +1,20 @@
 #include "interface/commands/cmd_dat.h"
 
+#include <sstream>
+#include <charconv>
+
 namespace Interface
 {
 	namespace DAT
 	{
 		void DatExtract(const ArgParser& parser, const Log& output)
 		{
+			dat::SegmentFilter filter;
+			if (!ParseSegmentFilter(parser, filter, output)) return;
+
 			if (parser.hasFlag("r") || parser.hasFlag("recursive"))
 			{
-				RecursiveExtract(parser, output, ".dat", &DoExtraction);
+				RecursiveDatExtract(parser, output, filter);
 				return;
 			}
 
@@ -20,37 +26,240 @@ namespace Interface
 
 			std::string filepath{ *parser.arg(0) }, outpath{ *parser.arg(1) };
 
-			DoExtraction(filepath, outpath, output);
+			DoExtraction(filepath, outpath, output, filter);
+		}
+
+		bool ParseSegmentFilter(const ArgParser& parser, dat::SegmentFilter& filter, const Log& output)
+		{
+			auto split = [](const std::string& list)
+				{
+					std::vector<std::string> ret;
+					std::stringstream stream(list);
+					for (std::string item; std::getline(stream, item, ',');)
+						if (!item.empty()) ret.push_back(item);
+					return ret;
+				};
+
+			if (auto types = parser.getSwitch("type"))	  filter.include = split(*types);
+			if (auto types = parser.getSwitch("exclude")) filter.exclude = split(*types);
+			if (auto ranges = parser.getSwitch("index"); ranges && !parseIndexRanges(*ranges, filter.ranges))
+			{
+				output.log(Level::ERROR, "Invalid Index Range: " + *ranges);
+				return false;
+			}
+			return true;
+		}
+
+		void RecursiveDatExtract(const ArgParser& parser, const Log& output, const dat::SegmentFilter& filter)
+		{
+			std::string directory = parser.argc() ? *parser.arg(0) : std::filesystem::current_path().string();
+
+			output.log(Level::LOG, "Recursive Extracting All 'dat's In Directory: " + directory);
+			output.setLevel(Level::SILENT);
+
+			// Files and their segments share one pool, so a single large DAT still spreads across every thread
+			thread_pool pool;
+			for (auto& file : std::filesystem::recursive_directory_iterator(directory))
+			{
+				if (!std::filesystem::is_regular_file(file)) continue;
+				if (StringToLower(file.path().extension().string()) != ".dat") continue;
+
+				std::filesystem::path filepath = file.path(), outpath = file.path().parent_path() / (file.path().stem().string() + "-dat");
+				pool.push_task([filepath, outpath, &output, &pool, &filter]
+					{
+						try { DoExtraction(filepath, outpath, output, pool, filter); }
+						catch (const std::exception&) {}			// Already logged
+					});
+			}
+
+			pool.wait_for_tasks();
+			output.setLevel(Level::LOG);
+			output.log(Level::LOG, "Done!");
 		}
 
-		void DoExtraction(const std::filesystem::path& filepath, const std::filesystem::path& outpath, const Log& output)
+		template<class dat_t>
+		static void ExtractDat(ByteView data, const std::filesystem::path& outpath, const Log& output, thread_pool& pool, const dat::SegmentFilter& filter)
+		{
+			dat_t datFile(output);
+			if (!datFile.loadFromMemory(data))
+				output.log(Level::EXCEPTION, EXCEPT_TEXT("\t\tFailed Validation. Cannot Open File"));
+
+			output.log(Level::LOG, "Extracting DAT To: " + outpath.string());
+			datFile.extractAll(outpath.string(), pool, filter);
+		}
+
+		void DoExtraction(const std::filesystem::path& filepath, const std::filesystem::path& outpath, const Log& output, const dat::SegmentFilter& filter)
+		{
+			thread_pool pool;
+			DoExtraction(filepath, outpath, output, pool, filter);
+		}
+
+		void DoExtraction(const std::filesystem::path& filepath, const std::filesystem::path& outpath, const Log& output, thread_pool& pool, const dat::SegmentFilter& filter)
 		{
 			if (!std::filesystem::exists(filepath)) { output.log(Level::ERROR, "Unable To Locate Requested File!"); return; }
 			if (filepath.extension().string() != ".dat") return;
 			if (std::filesystem::file_size(filepath) == 0) return;
 
-			output.log(Level::VERBOSE, "\tFile Opened As Little Endian...");
-			le_DatFile le_datFile(output);
-			if (le_datFile.loadFromFile(filepath.string()))
+			// The file is mapped once. Endianness is decided from the header, and segments are written straight out of the mapping
+			MappedFile file(filepath.string());
+			if (!file.is_open()) { output.log(Level::ERROR, "Unable To Open Requested File!"); return; }
+
+			ByteView   data = file.view(0, file.size());
+			if (le_DatFile::probe(data, data.size()))
 			{
-				output.log(Level::LOG, "Extracting DAT To: " + outpath.string());
-				le_datFile.extractAll(outpath.string());
+				output.log(Level::VERBOSE, "\tFile Opened As Little Endian...");
+				ExtractDat<le_DatFile>(data, outpath, output, pool, filter);
+			}
+			else if (be_DatFile::probe(data, data.size()))
+			{
+				output.log(Level::VERBOSE, "\tFile Opened As Big Endian...");
+				ExtractDat<be_DatFile>(data, outpath, output, pool, filter);
 			}
 			else
+				output.log(Level::EXCEPTION, EXCEPT_TEXT("\t\tFailed Validation. Cannot Open File"));
+		}
+
+		void DeepExtract(const ArgParser& parser, const Log& output)
+		{
+			std::vector<std::pair<std::filesystem::path, std::filesystem::path>> targets;
+			if (parser.hasFlag("r") || parser.hasFlag("recursive"))
+			{
+				std::string directory = parser.argc() ? *parser.arg(0) : std::filesystem::current_path().string();
+				for (auto& file : std::filesystem::recursive_directory_iterator(directory))
+				{
+					if (!std::filesystem::is_regular_file(file)) continue;
+					if (StringToLower(file.path().extension().string()) != ".dat") continue;
+					targets.push_back({ file.path(), file.path().parent_path() / (file.path().stem().string() + "-dat") });
+				}
+			}
+			else if (parser.argc() < 2)
+			{
+				output.log(Level::ERROR, DeepExtract_help_text);
+				return;
+			}
+			else
+				targets.push_back({ *parser.arg(0), *parser.arg(1) });
+
+			std::vector<MappedFile>  files;									// Roots stay mapped until every nested task is done
+			std::vector<std::string> formats;
+			std::vector<std::filesystem::path> outpaths;
+			for (const auto& [filepath, outpath] : targets)
+			{
+				std::string format = StringToLower(filepath.extension().string());
+				if (!format.empty()) format = format.substr(1);
+				if (!DeepExtraction::supports(format)) { output.log(Level::ERROR, "Unsupported Format: " + filepath.string()); continue; }
+
+				MappedFile file(filepath.string());
+				if (!file.is_open()) { output.log(Level::ERROR, "Unable To Open Requested File: " + filepath.string()); continue; }
+				if (!file.size()) continue;
+
+				output.log(Level::LOG, "Deep Extracting " + filepath.string() + " To: " + outpath.string());
+				files.push_back(std::move(file));
+				formats.push_back(format);
+				outpaths.push_back(outpath);
+			}
+
+			DeepExtraction extraction(output);
+			output.setLevel(Level::SILENT);
+			for (size_t i = 0; i < files.size(); i++)
+				extraction.schedule(files[i].view(0, files[i].size()), formats[i], outpaths[i]);
+			extraction.pool.wait_for_tasks();
+			output.setLevel(Level::LOG);
+
+			for (const auto& failure : extraction.failures)
+				output.log(Level::ERROR, failure);
+			output.log(Level::LOG, "Done!");
+		}
+
+		bool DeepExtraction::supports(const std::string& format)
+		{
+			return format == "dat" || format == "tpl" || format == "smd" || format == "etm" || format == "itm";
+		}
+
+		void DeepExtraction::schedule(ByteView data, const std::string& format, const std::filesystem::path& outpath)
+		{
+			pool.push_task([this, data, format, outpath]
+				{
+					try { extract(data, format, outpath); }
+					catch (const std::exception& e)
+					{
+						std::lock_guard<std::mutex> guard(lock);
+						failures.push_back("\tFailed To Extract " + outpath.string() + ": " + e.what());
+					}
+				});
+		}
+
+		void DeepExtraction::extract(ByteView data, const std::string& format, const std::filesystem::path& outpath)
+		{
+			if (format != "dat") std::filesystem::create_directories(outpath);	// DATs create theirs once they validate
+
+			if (format == "dat")
+			{
+				if		(le_DatFile::probe(data, data.size())) extractDat<le_DatFile>(data, outpath);
+				else if (be_DatFile::probe(data, data.size())) extractDat<be_DatFile>(data, outpath);
+				else throw std::runtime_error("Failed Validation. Unknown Endianness");
+			}
+			else if (format == "tpl")
+			{
+				tpl::TplFile tplFile(output);
+				tplFile.loadFromMemory(data);
+				tplFile.decompileAll(outpath.string() + "/");
+			}
+			else if (format == "smd")
+			{
+				smd::SmdFile<std::endian::little> smdFile(output);
+				if (!smdFile.loadFromMemory(data)) throw std::runtime_error("Unable To Load SMD");
+				smdFile.extract(outpath.string());
+				smdFile.decompileTpl(outpath.string() + "/texture");
+			}
+			else if (format == "etm")
+			{
+				etm::EtmFile etmFile(output);
+				etmFile.loadFromMemory(data);
+				etmFile.extractAll(outpath.string());
+			}
+			else if (format == "itm")
+			{
+				itm::ItmFile itmFile(output);
+				itmFile.loadFromMemory(data);
+				itmFile.extractBins(outpath.string());
+				itmFile.decompileTpls(outpath.string());
+			}
+		}
+
+		template<class dat_t>
+		void DeepExtraction::extractDat(ByteView data, const std::filesystem::path& outpath)
+		{
+			dat_t datFile(output);
+			if (!datFile.loadFromMemory(data)) throw std::runtime_error("Failed Validation. Cannot Open File");
+			std::filesystem::create_directories(outpath);
+
+			// Known formats are handed to their own task. Everything else is written as dat-extract would
+			for (size_t i = 0; i < datFile.size(); i++)
 			{
-				output.log(Level::ERROR, "\t\tFailed Validation, Attempting Big Endian...");
-				be_DatFile be_datFile(output);
+				std::string format = StringToLower(datFile.format(i));
+				ByteView	segment = datFile.segment(i);
 
-				if (!be_datFile.loadFromFile(filepath.string()))
-					output.log(Level::EXCEPTION, EXCEPT_TEXT("\t\tFailed Validation. Cannot Open File"));
+				if (supports(format) && !segment.empty())
+				{
+					schedule(segment, format, outpath / (std::to_string(i) + "-" + format));
+					continue;
+				}
 
-				output.log(Level::LOG, "Extracting DAT To: " + outpath.string());
-				be_datFile.extractAll(outpath.string());
+				NativeFile out((outpath / (std::to_string(i) + "." + (format.empty() ? "DMY" : datFile.format(i)))).string(), NativeFile::Mode::WRITE);
+				if (!out.is_open() || !out.write(0, segment.data(), segment.size()))
+					throw std::runtime_error("Unable To Write Segment " + std::to_string(i));
 			}
 		}
 
 		void DatBuild(const ArgParser& parser, const Log& output)
 		{
+			if (parser.hasFlag("r") || parser.hasFlag("recursive"))
+			{
+				RecursiveDatBuild(parser, output);
+				return;
+			}
+
 			if (parser.argc() < 2)
 			{
 				output.log(Level::ERROR, DatBuild_help_text);
@@ -66,5 +275,102 @@ namespace Interface
 			output.log(Level::LOG, "Saving DAT File To: " + outpath);
 			datFile.save(outpath);
 		}
+
+		// A rebuilt folder overwrites the file it was extracted from, keeping its extension and case. Otherwise a parent rebuild would
+		// find both files for the index and scanNumericDirectory would keep the stale one
+		static std::filesystem::path RebuildTarget(const std::filesystem::path& source)
+		{
+			std::string name = source.filename().string(), stem = name.substr(0, name.size() - 4);
+			std::filesystem::path parent = source.parent_path();
+
+			size_t index{};
+			auto [end, result] = std::from_chars(stem.data(), stem.data() + stem.size(), index);
+			if (result == std::errc() && end == stem.data() + stem.size())
+			{
+				for (const auto& file : scanNumericDirectory(parent.string()))
+					if (file.index == index) return file.path;
+			}
+			else
+			{
+				std::error_code error;
+				for (const auto& entry : std::filesystem::directory_iterator(parent, error))
+					if (entry.is_regular_file(error) && entry.path().stem().string() == stem && StringToLower(entry.path().extension().string()) == ".dat")
+						return entry.path();
+			}
+			return parent / (stem + ".dat");
+		}
+
+		void RecursiveDatBuild(const ArgParser& parser, const Log& output)
+		{
+			std::string directory = parser.argc() ? *parser.arg(0) : std::filesystem::current_path().string();
+			if (!std::filesystem::is_directory(directory)) { output.log(Level::ERROR, "Unable To Locate Requested Directory!"); return; }
+
+			output.log(Level::LOG, "Recursive Building All '-dat' Directories In: " + directory);
+
+			std::vector<std::filesystem::path> sources;
+			for (auto& entry : std::filesystem::recursive_directory_iterator(directory))
+			{
+				if (!entry.is_directory()) continue;
+				std::string name = entry.path().filename().string();
+				if (name.size() > 4 && StringToLower(name.substr(name.size() - 4)) == "-dat")
+					sources.push_back(entry.path());
+			}
+
+			// Deepest first, so a nested extraction is packed back into its parent folder before that folder is built
+			auto depth = [](const std::filesystem::path& path) { return std::distance(path.begin(), path.end()); };
+			std::stable_sort(sources.begin(), sources.end(), [&](const auto& lhs, const auto& rhs) { return depth(lhs) > depth(rhs); });
+
+			struct Result
+			{
+				std::filesystem::path target;
+				size_t				  segments{};
+				uintmax_t			  bytes{};
+				bool				  built{};
+			};
+			std::vector<Result> results(sources.size());
+
+			output.setLevel(Level::SILENT);
+			thread_pool pool;
+			for (size_t first = 0, last = 0; first < sources.size(); first = last)
+			{
+				while (last < sources.size() && depth(sources[last]) == depth(sources[first])) last++;
+				for (size_t i = first; i < last; i++)						// Before any task of the batch writes into a parent folder
+					results[i].target = RebuildTarget(sources[i]);
+
+				for (size_t i = first; i < last; i++)
+					pool.push_task([&sources, &results, &output, i]
+						{
+							Result& result = results[i];
+
+							try
+							{
+								dat::DatFile datFile(output);
+								datFile.addDir(sources[i].string());
+								result.segments = datFile.size();
+								result.built	= result.segments && datFile.save(result.target.string());
+							}
+							catch (const std::exception&) { result.built = false; }
+
+							std::error_code error;
+							if (result.built) result.bytes = std::filesystem::file_size(result.target, error);
+						});
+				pool.wait_for_tasks();
+			}
+			output.setLevel(Level::LOG);
+
+			size_t built{}, segments{};
+			uintmax_t bytes{};
+			for (const auto& result : results)
+			{
+				if (!result.built) { output.log(Level::ERROR, "\tFailed To Rebuild: " + result.target.string()); continue; }
+
+				output.log(Level::LOG, "\t" + result.target.string() + " (" + std::to_string(result.segments) + " Segments, " + std::to_string(result.bytes) + " Bytes)");
+				built++;
+				segments += result.segments;
+				bytes	 += result.bytes;
+			}
+			output.log(Level::LOG, "Rebuilt " + std::to_string(built) + " Of " + std::to_string(results.size()) + " DAT Files. " +
+				std::to_string(segments) + " Segments, " + std::to_string(bytes) + " Bytes Written.");
+		}
 	}
 }
@@ -1,5 +1,8 @@
 #include "interface/commands/cmd_tpl.h"
 
+#include <cmath>
+#include <cstdio>
+#include <charconv>
 
 namespace Interface
 {
@@ -89,6 +92,204 @@ namespace Interface
 			DoDecompile(filepath, outpath, output);
 		}
 
+		void TplCompile(const ArgParser& parser, const Log& output)
+		{
+			if (parser.argc() < 2)
+			{
+				output.log(Level::ERROR, TplCompile_help_text);
+				return;
+			}
+
+			std::string filepath{ *parser.arg(0) }, path{ *parser.arg(1) };
+			if (!std::filesystem::is_directory(path)) { output.log(Level::ERROR, "Unable To Locate Requested Directory!"); return; }
+
+			tpl::CompileOptions options;
+			options.depth	= parser.hasFlag("4bit") ? 4 : parser.hasFlag("32bit") ? 32 : 8;
+			options.dither	= parser.hasFlag("dither");
+			options.swizzle = parser.hasFlag("swizzle");
+
+			output.log(Level::LOG, "Compiling TPL File From: " + path);
+			tpl::TplFile tplFile(output);
+			if (!tplFile.compile(path, options)) { output.log(Level::ERROR, "Unable To Compile Every Image. Nothing Was Saved."); return; }
+
+			output.log(Level::LOG, "Saving TPL File To: " + filepath);
+			tplFile.save(filepath);
+		}
+
+		// Error is the mean squared distance summed over four channels, so PSNR is taken over a quarter of it
+		static double toPSNR(const double& error)	{ return error > 0.0 ? 10.0 * std::log10(255.0 * 255.0 * 4.0 / error) : INFINITY; }
+		static double fromPSNR(const double& psnr)	{ return 255.0 * 255.0 * 4.0 / std::pow(10.0, psnr / 10.0); }
+
+		static std::string FormatPSNR(const double& error)
+		{
+			if (std::isinf(error) && error > 0.0) return "Mipmap Size Unsupported";
+			if (error <= 0.0) return "Exact";
+
+			char text[32];
+			std::snprintf(text, sizeof(text), "%.1f dB", toPSNR(error));
+			return text;
+		}
+
+		void TplRequantize(const ArgParser& parser, const Log& output)
+		{
+			RequantizeOptions options;
+			if (!ParseRequantizeOptions(parser, options, output)) return;
+
+			if (parser.hasFlag("r") || parser.hasFlag("recursive"))
+			{
+				RecursiveRequantize(parser, output, options);
+				return;
+			}
+
+			if (parser.argc() < 1)
+			{
+				output.log(Level::ERROR, TplRequantize_help_text);
+				return;
+			}
+
+			std::string filepath{ *parser.arg(0) }, outpath{ parser.argc() > 1 ? *parser.arg(1) : filepath };
+			if (!std::filesystem::exists(filepath)) { output.log(Level::ERROR, "Unable To Locate Requested File!"); return; }
+
+			output.log(Level::LOG, "Requantizing TPL File: " + filepath);
+			output.setLevel(Level::SILENT);
+			thread_pool pool;
+			std::vector<tpl::Requantization> results;
+			bool loaded{};
+			try { results = DoRequantize(filepath, outpath, options, pool, output); loaded = true; }
+			catch (const std::exception&) {}			// Already logged
+			output.setLevel(Level::LOG);
+			if (!loaded) { output.log(Level::ERROR, "Unable To Requantize: " + filepath); return; }
+
+			uint64_t before{}, after{};
+			size_t converted{}, candidates{};
+			for (size_t i = 0; i < results.size(); i++)
+			{
+				const auto& result = results[i];
+				if (!result.before) continue;
+
+				candidates++;
+				std::string line = "\t[" + std::to_string(i) + "] " + FormatPSNR(result.error);
+				if (result.converted)
+				{
+					line += ", " + std::to_string(result.before) + " -> " + std::to_string(result.after) + " Bytes";
+					before += result.before;
+					after  += result.after;
+					converted++;
+				}
+				else if (std::isinf(result.error))
+					line += ", Kept 32-bit";
+				else
+					line += result.after >= result.before ? ", Kept 32-bit (No Space Saved)" : ", Kept 32-bit (Below Quality Threshold)";
+				output.log(Level::LOG, line);
+			}
+
+			output.log(Level::LOG, "Converted " + std::to_string(converted) + " Of " + std::to_string(candidates) + " 32-bit Textures. " +
+				std::to_string(before - after) + " Bytes Saved.");
+			if (converted || outpath != filepath) output.log(Level::LOG, "Saved TPL File To: " + outpath);
+		}
+
+		bool ParseRequantizeOptions(const ArgParser& parser, RequantizeOptions& options, const Log& output)
+		{
+			options.compile.depth	= parser.hasFlag("4bit") ? 4 : 8;
+			options.compile.dither	= parser.hasFlag("dither");
+			options.compile.swizzle = parser.hasFlag("swizzle");
+
+			double psnr = 30.0;
+			if (auto value = parser.getSwitch("psnr"))
+			{
+				auto [end, result] = std::from_chars(value->data(), value->data() + value->size(), psnr);
+				if (result != std::errc() || end != value->data() + value->size() || psnr < 0.0)
+				{
+					output.log(Level::ERROR, "Invalid PSNR: " + *value);
+					return false;
+				}
+			}
+			options.maxError = fromPSNR(psnr);
+
+			if (auto ranges = parser.getSwitch("index"); ranges && !parseIndexRanges(*ranges, options.ranges))
+			{
+				output.log(Level::ERROR, "Invalid Index Range: " + *ranges);
+				return false;
+			}
+			return true;
+		}
+
+		void RecursiveRequantize(const ArgParser& parser, const Log& output, const RequantizeOptions& options)
+		{
+			std::string directory = parser.argc() ? *parser.arg(0) : std::filesystem::current_path().string();
+			if (!std::filesystem::is_directory(directory)) { output.log(Level::ERROR, "Unable To Locate Requested Directory!"); return; }
+
+			output.log(Level::LOG, "Recursive Requantizing All 'tpl's In Directory: " + directory);
+
+			std::vector<std::filesystem::path> files;
+			for (auto& file : std::filesystem::recursive_directory_iterator(directory))
+				if (std::filesystem::is_regular_file(file) && StringToLower(file.path().extension().string()) == ".tpl")
+					files.push_back(file.path());
+
+			struct Result
+			{
+				std::vector<tpl::Requantization> entries;
+				bool							 loaded{};
+			};
+			std::vector<Result> results(files.size());
+
+			// Files and their entries share one pool, so a single large TPL still spreads across every thread
+			output.setLevel(Level::SILENT);
+			thread_pool pool;
+			for (size_t i = 0; i < files.size(); i++)
+				pool.push_task([&files, &results, &options, &output, &pool, i]
+					{
+						try
+						{
+							results[i].entries = DoRequantize(files[i], files[i], options, pool, output);
+							results[i].loaded  = true;
+						}
+						catch (const std::exception&) {}			// Already logged
+					});
+			pool.wait_for_tasks();
+			output.setLevel(Level::LOG);
+
+			uint64_t before{}, after{};
+			size_t converted{}, candidates{}, changed{};
+			for (size_t i = 0; i < files.size(); i++)
+			{
+				if (!results[i].loaded) { output.log(Level::ERROR, "\tFailed To Requantize: " + files[i].string()); continue; }
+
+				size_t fileConverted{};
+				uint64_t saved{};
+				for (const auto& result : results[i].entries)
+				{
+					if (!result.before) continue;
+					candidates++;
+					if (!result.converted) continue;
+
+					fileConverted++;
+					saved  += result.before - result.after;
+					before += result.before;
+					after  += result.after;
+				}
+				if (!fileConverted) continue;
+
+				output.log(Level::LOG, "\t" + files[i].string() + " (" + std::to_string(fileConverted) + " Textures, " + std::to_string(saved) + " Bytes Saved)");
+				converted += fileConverted;
+				changed++;
+			}
+			output.log(Level::LOG, "Converted " + std::to_string(converted) + " Of " + std::to_string(candidates) + " 32-bit Textures In " +
+				std::to_string(changed) + " Files. " + std::to_string(before - after) + " Bytes Saved.");
+		}
+
+		std::vector<tpl::Requantization> DoRequantize(const std::filesystem::path& filepath, const std::filesystem::path& outpath, const RequantizeOptions& options, thread_pool& pool, const Log& output)
+		{
+			tpl::TplFile tplFile(filepath.string(), output);
+			auto results = tplFile.requantize(options.compile, options.maxError, pool, options.ranges);
+
+			// Files are only rewritten in place when something changed
+			bool converted = std::any_of(results.begin(), results.end(), [](const tpl::Requantization& result) { return result.converted; });
+			if (converted || outpath != filepath)
+				tplFile.save(outpath.string());
+			return results;
+		}
+
 		void DoDecompile(const std::filesystem::path& filepath, const std::filesystem::path& outpath, const Log& output)
 		{
 			if (!std::filesystem::exists(filepath)) { output.log(Level::ERROR, "Unable To Locate Requested File!"); return; }
@@ -1,36 +1,71 @@
 #include "interface/common.h"
 
+#include <charconv>
+#include <sstream>
+
 namespace Interface
 {
-	std::vector<std::string> getSequentialNumericFilenames(const std::string& path)
+	std::vector<NumericFile> scanNumericDirectory(const std::string& path)
 	{
-		std::vector<std::string> ret;
-		ret.resize(getHighestFileNumber(path));
+		std::vector<NumericFile> ret;
 
-		size_t index{ 0 };
-		for (const auto& entry : std::filesystem::directory_iterator(path))
+		std::error_code error;
+		for (const auto& entry : std::filesystem::directory_iterator(path, error))
 		{
-			index = std::stoi(entry.path().stem().string());
-			ret[index] = entry.path().string();
+			if (!entry.is_regular_file(error)) continue;
+
+			std::string stem = entry.path().stem().string();
+			size_t index{};
+			auto [end, result] = std::from_chars(stem.data(), stem.data() + stem.size(), index);
+			if (result != std::errc() || end != stem.data() + stem.size()) continue;
+
+			uint64_t size = entry.file_size(error);
+			if (error) continue;
+
+			ret.push_back({ index, size, entry.path().extension().string(), entry.path().string() });
 		}
 
-		for (size_t i = ret.size() - 1; i >= 0; i--)
-			if (ret[i].empty()) ret.erase(ret.begin() + i);
+		std::sort(ret.begin(), ret.end(), [](const NumericFile& lhs, const NumericFile& rhs)
+			{ return lhs.index != rhs.index ? lhs.index < rhs.index : lhs.path < rhs.path; });
+		ret.erase(std::unique(ret.begin(), ret.end(), [](const NumericFile& lhs, const NumericFile& rhs)
+			{ return lhs.index == rhs.index; }), ret.end());
 
 		return ret;
 	}
 
-	size_t getHighestFileNumber(const std::string& path)
+	bool parseIndexRanges(const std::string& list, std::vector<std::pair<size_t, size_t>>& ranges)
 	{
-		size_t ret{ 0 };
-		size_t comparitor{ 0 };
-
-		for (const auto& entry : std::filesystem::directory_iterator(path))
+		std::stringstream stream(list);
+		for (std::string range; std::getline(stream, range, ',');)
 		{
-			comparitor = std::stoi(entry.path().stem().string());
-			if (ret < comparitor) ret = comparitor;
+			if (range.empty()) continue;
+
+			size_t dash = range.find('-');
+			std::string first = range.substr(0, dash), last = dash == std::string::npos ? first : range.substr(dash + 1);
+
+			size_t begin{}, end{ SIZE_MAX };
+			bool valid = std::from_chars(first.data(), first.data() + first.size(), begin).ec == std::errc();
+			if (!last.empty())
+				valid &= std::from_chars(last.data(), last.data() + last.size(), end).ec == std::errc();
+			if (!valid || begin > end) return false;
+
+			ranges.push_back({ begin, end });
 		}
-		return ret + 1;
+		return true;
+	}
+
+	std::vector<std::string> getSequentialNumericFilenames(const std::string& path)
+	{
+		std::vector<std::string> ret;
+		for (auto& file : scanNumericDirectory(path))
+			ret.push_back(std::move(file.path));
+		return ret;
+	}
+
+	size_t getHighestFileNumber(const std::string& path)
+	{
+		auto files = scanNumericDirectory(path);
+		return files.empty() ? 0 : files.back().index + 1;
 	}
 
 	uint32_t allign(const uint32_t& OFFSET, const uint32_t& BLOCK_ALLIGNMENT)
@@ -58,6 +93,20 @@ namespace Interface
 		return data;
 	}
 
+	bool matchWildcard(std::string_view pattern, std::string_view text)
+	{
+		size_t p{ 0 }, t{ 0 }, star{ std::string_view::npos }, resume{ 0 };
+		while (t < text.size())
+		{
+			if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) { p++; t++; }
+			else if (p < pattern.size() && pattern[p] == '*')						 { star = p++; resume = t; }
+			else if (star != std::string_view::npos)										 { p = star + 1; t = ++resume; }
+			else return false;
+		}
+		while (p < pattern.size() && pattern[p] == '*') p++;
+		return p == pattern.size();
+	}
+
 	ByteArray getFileData(const std::string& path)
 	{
 		ByteArray rawData;
@@ -10,11 +10,13 @@ namespace Interface
 
 	void Log::setLevel(const Level& level) const
 	{
+		std::lock_guard<std::recursive_mutex> guard(lock);
 		logLevel = level;
 	}
 
 	void Log::log(const Level& severity, const std::string& msg) const
 	{
+		std::lock_guard<std::recursive_mutex> guard(lock);
 		history.push_back(msg + "\n");
 		for (auto probe : probes)
 		{
@@ -0,0 +1,218 @@
+#include "sys_file.h"
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#ifdef __linux__
+		#include <sys/sendfile.h>
+	#endif
+#endif
+
+#include <vector>
+#include <algorithm>
+
+static const size_t COPY_BUFFER_SIZE{ 0x100000 };							// Fallback copy chunk. Keeps memory flat regardless of entry size
+
+bool MappedFile::open(const std::string& path)
+{
+	close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER filesize{};
+	if (!GetFileSizeEx(file, &filesize)) { CloseHandle(file); return false; }
+	length = static_cast<size_t>(filesize.QuadPart);
+
+	if (length)																	// Windows refuses to map empty files
+	{
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping) begin = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	}
+	CloseHandle(file);															// The mapping keeps its own reference to the file
+
+	if (length && !begin) { close(); return false; }
+#else
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat info{};
+	if (fstat(fd, &info) != 0) { ::close(fd); return false; }
+	length = static_cast<size_t>(info.st_size);
+
+	if (length)																	// mmap refuses zero length mappings
+	{
+		void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (address != MAP_FAILED) begin = static_cast<const std::byte*>(address);
+	}
+	::close(fd);																// The mapping keeps its own reference to the file
+
+	if (length && !begin) { length = 0; return false; }
+#endif
+
+	opened = true;
+	return true;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+	if (begin)   UnmapViewOfFile(begin);
+	if (mapping) CloseHandle(mapping);
+#else
+	if (begin)   munmap(const_cast<std::byte*>(begin), length);
+#endif
+	begin   = nullptr;
+	length  = 0;
+	mapping = nullptr;
+	opened  = false;
+}
+
+bool NativeFile::open(const std::string& path, const Mode& mode)
+{
+	close();
+
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	switch (mode)
+	{
+	case Mode::READ:   file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr); break;
+	case Mode::WRITE:  file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr); break;
+	case Mode::MODIFY: file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr); break;
+	}
+	if (file == INVALID_HANDLE_VALUE) return false;
+	handle = reinterpret_cast<intptr_t>(file);
+#else
+	int fd = -1;
+	switch (mode)
+	{
+	case Mode::READ:   fd = ::open(path.c_str(), O_RDONLY); break;
+	case Mode::WRITE:  fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644); break;
+	case Mode::MODIFY: fd = ::open(path.c_str(), O_RDWR); break;
+	}
+	if (fd < 0) return false;
+	handle = fd;
+#endif
+	return true;
+}
+
+void NativeFile::close()
+{
+	if (!is_open()) return;
+#ifdef _WIN32
+	CloseHandle(reinterpret_cast<HANDLE>(handle));
+#else
+	::close(static_cast<int>(handle));
+#endif
+	handle = -1;
+}
+
+uint64_t NativeFile::size() const
+{
+#ifdef _WIN32
+	LARGE_INTEGER filesize{};
+	if (!GetFileSizeEx(reinterpret_cast<HANDLE>(handle), &filesize)) return 0;
+	return static_cast<uint64_t>(filesize.QuadPart);
+#else
+	struct stat info{};
+	if (fstat(static_cast<int>(handle), &info) != 0) return 0;
+	return static_cast<uint64_t>(info.st_size);
+#endif
+}
+
+bool NativeFile::read(const uint64_t& offset, void* buffer, const size_t& count) const
+{
+	auto*  cursor	 = static_cast<char*>(buffer);
+	size_t remaining = count;
+	while (remaining)
+	{
+		const uint64_t position = offset + (count - remaining);
+#ifdef _WIN32
+		OVERLAPPED overlapped{};
+		overlapped.Offset	  = static_cast<DWORD>(position);
+		overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+		DWORD done{};
+		if (!ReadFile(reinterpret_cast<HANDLE>(handle), cursor, static_cast<DWORD>(std::min<size_t>(remaining, 0x40000000)), &done, &overlapped)) return false;
+#else
+		ssize_t done = pread(static_cast<int>(handle), cursor, remaining, static_cast<off_t>(position));
+		if (done < 0) return false;
+#endif
+		if (done == 0) return false;											// Hit end of file early
+		cursor	  += done;
+		remaining -= done;
+	}
+	return true;
+}
+
+bool NativeFile::write(const uint64_t& offset, const void* buffer, const size_t& count) const
+{
+	auto*  cursor	 = static_cast<const char*>(buffer);
+	size_t remaining = count;
+	while (remaining)
+	{
+		const uint64_t position = offset + (count - remaining);
+#ifdef _WIN32
+		OVERLAPPED overlapped{};
+		overlapped.Offset	  = static_cast<DWORD>(position);
+		overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+		DWORD done{};
+		if (!WriteFile(reinterpret_cast<HANDLE>(handle), cursor, static_cast<DWORD>(std::min<size_t>(remaining, 0x40000000)), &done, &overlapped)) return false;
+#else
+		ssize_t done = pwrite(static_cast<int>(handle), cursor, remaining, static_cast<off_t>(position));
+		if (done < 0) return false;
+#endif
+		if (done == 0) return false;
+		cursor	  += done;
+		remaining -= done;
+	}
+	return true;
+}
+
+bool NativeFile::copy(const NativeFile& source, uint64_t source_offset, const NativeFile& destination, uint64_t destination_offset, uint64_t count)
+{
+	if (!source.is_open() || !destination.is_open()) return false;
+
+#ifdef __linux__
+	const int in  = static_cast<int>(source.handle);
+	const int out = static_cast<int>(destination.handle);
+
+	// Kernel side copy. Filesystems that support it may even share extents instead of copying
+	while (count)
+	{
+		off_t   in_offset  = static_cast<off_t>(source_offset);
+		off_t   out_offset = static_cast<off_t>(destination_offset);
+		ssize_t done	   = copy_file_range(in, &in_offset, out, &out_offset, count, 0);
+		if (done <= 0) break;													// Unsupported (EXDEV, ENOSYS, EINVAL...) or EOF. Try the next method
+		source_offset += done; destination_offset += done; count -= done;
+	}
+
+	// sendfile writes at the destination cursor, so it has to be placed first
+	if (count && lseek(out, static_cast<off_t>(destination_offset), SEEK_SET) >= 0)
+		while (count)
+		{
+			off_t   in_offset = static_cast<off_t>(source_offset);
+			ssize_t done	  = sendfile(out, in, &in_offset, count);
+			if (done <= 0) break;
+			source_offset += done; destination_offset += done; count -= done;
+		}
+#endif
+
+	if (!count) return true;
+
+	std::vector<char> buffer(static_cast<size_t>(std::min<uint64_t>(count, COPY_BUFFER_SIZE)));
+	while (count)
+	{
+		const size_t chunk = static_cast<size_t>(std::min<uint64_t>(count, buffer.size()));
+		if (!source.read(source_offset, buffer.data(), chunk))			  return false;
+		if (!destination.write(destination_offset, buffer.data(), chunk)) return false;
+		source_offset += chunk; destination_offset += chunk; count -= chunk;
+	}
+	return true;
+}
@@ -1,5 +1,7 @@
 #include "afs.h"
 
+#include <charconv>
+
 namespace afs
 {
 	AfsFile::AfsFile(const std::string& path, const Interface::Log& log) : Logger(&log), datInfo(log)
@@ -7,22 +9,37 @@ namespace afs
 		loadFromFile(path);
 	}
 
-	void AfsFile::extract(const size_t& index, const std::string& path, const bool& ignore_empty)
+	std::string AfsFile::entryPath(const size_t& index, const std::string& path)
 	{
-		if (index > file_count) return;
-		if (files[index].rawData.empty() && ignore_empty) return;
-
-		std::string outpath;
 		if(datInfo[index].filename == "_")
-			outpath = path + "/" + file_table.entries[index].filename;
+			return path + "/" + file_table.entries[index].filename.c_str();		// c_str drops the 0x20 byte padding
 		else
-			outpath = path + "/" + datInfo[index].filename;
+			return path + "/" + std::string(datInfo[index].filename);
+	}
+
+	bool AfsFile::writeEntry(const size_t& index, const std::string& outpath)
+	{
+		NativeFile out(outpath, NativeFile::Mode::WRITE);
+		if (!out.is_open()) return false;
+
+		Entry& file = files[index];
+		if (archive.is_open() && file.rawData.empty() && !file.view.empty())		// Mapped entry. Let the OS copy straight from the archive
+			return NativeFile::copy(archive, file.offset.cast(), out, 0, file.size.cast());
 
+		ByteView data = file.data();
+		return out.write(0, data.data(), data.size());
+	}
+
+	void AfsFile::extract(const size_t& index, const std::string& path, const bool& ignore_empty)
+	{
+		if (index >= files.size()) return;
+		if (files[index].data().empty() && ignore_empty) return;
+
+		std::string outpath = entryPath(index, path);
 		Interface::createSavePath(outpath);
 
-		std::ofstream stream(outpath, std::ios::binary);
-		stream.write((char*)files[index].rawData.data(), files[index].size);
-		stream.close();
+		if (!writeEntry(index, outpath))
+			print(Level::ERROR, "\tUnable To Extract Entry: " + outpath);
 	}
 
 	void AfsFile::extract(const std::string& name, const std::string& path, const bool& ignore_empty)
@@ -30,21 +47,109 @@ namespace afs
 		extract(indexFromName(name), path, ignore_empty);
 	}
 
+	std::pair<size_t, size_t> AfsFile::extractedRange(const size_t& count)
+	{
+		if (count < 2) return { 0, 0 };
+		return { 1, count - 1 };
+	}
+
 	void AfsFile::extractAll(const std::string& path, const bool& ignore_empty)
 	{
-		for (uint32_t i = 1; i < file_count - 1; i++)
-			extract(i, path, ignore_empty);
+		auto [first, last] = extractedRange(file_count.cast());
+
+		std::vector<size_t> indices;
+		for (size_t i = first; i < last; i++)
+			indices.push_back(i);
+		extract(indices, path, ignore_empty);
+	}
+
+	void AfsFile::extract(std::vector<size_t> indices, const std::string& path, const bool& ignore_empty)
+	{
+		// Submit in archive order so reads sweep forward through the file
+		std::sort(indices.begin(), indices.end(), [this](const size_t& a, const size_t& b) { return files[a].offset.cast() < files[b].offset.cast(); });
+
+		std::vector<std::pair<size_t, std::string>> targets;
+		std::set<std::filesystem::path> directories;
+		for (const size_t& i : indices)
+		{
+			if (i >= files.size()) continue;
+			if (files[i].data().empty() && ignore_empty) continue;
+			targets.push_back({ i, entryPath(i, path) });
+			directories.insert(std::filesystem::path(targets.back().second).parent_path());
+		}
+
+		// Directories are created up front so the workers never race on create_directories
+		print(Level::VERBOSE, "\tCreating " + std::to_string(directories.size()) + " Directories");
+		for (const auto& directory : directories)
+			if (!directory.empty()) std::filesystem::create_directories(directory);
+
+		print(Level::LOG, "\tExtracting " + std::to_string(targets.size()) + " Entries");
+		std::vector<char> written(targets.size());
+		thread_pool pool;
+		for (size_t i = 0; i < targets.size(); i++)
+			pool.push_task([this, &targets, &written, i] { written[i] = writeEntry(targets[i].first, targets[i].second); });
+		pool.wait_for_tasks();
+
+		for (size_t i = 0; i < targets.size(); i++)
+			if (!written[i]) print(Level::ERROR, "\tUnable To Extract Entry: " + targets[i].second);
 	}
 
 	size_t AfsFile::indexFromName(const std::string& name)
 	{
-		for (size_t i = 0; i < file_count; i++)
-			if (file_table.entries[i].filename == name) return i;
-		return 0xffffffff;
+		auto found = name_index.find(name);
+		if (found == name_index.end()) return 0xffffffff;
+		return found->second;
+	}
+
+	void AfsFile::buildNameIndex()
+	{
+		name_index.clear();
+		name_index.reserve(file_table.entries.size() * 2);
+
+		for (size_t i = 0; i < file_table.entries.size(); i++)
+			name_index.emplace(file_table.entries[i].filename.c_str(), i);		// emplace keeps the first entry on duplicate names
+
+		const auto& paths = datInfo.getEntries();
+		for (size_t i = 0; i < paths.size() && i < files.size(); i++)
+			if (paths[i].filename != "_") name_index.emplace(paths[i].filename, i);
+	}
+
+	std::vector<size_t> AfsFile::resolveNames(const std::vector<std::string>& patterns)
+	{
+		std::vector<char> selected(files.size());
+		const auto& paths = datInfo.getEntries();
+
+		for (const auto& pattern : patterns)
+		{
+			if (pattern.find_first_of("*?") == std::string::npos)
+			{
+				size_t index = indexFromName(pattern);
+				if (index < files.size()) selected[index] = true;
+				else					  print(Level::ERROR, "\tNo Entry Named: " + pattern);
+				continue;
+			}
+
+			bool matched{ false };
+			for (size_t i = 0; i < files.size(); i++)
+			{
+				bool hit = matchWildcard(pattern, file_table.entries[i].filename.c_str());
+				if (!hit && i < paths.size()) hit = matchWildcard(pattern, paths[i].filename);
+				if (hit) selected[i] = matched = true;
+			}
+			if (!matched) print(Level::ERROR, "\tNo Entries Match: " + pattern);
+		}
+
+		std::vector<size_t> indices;
+		for (size_t i = 0; i < selected.size(); i++)
+			if (selected[i]) indices.push_back(i);
+		return indices;
 	}
 
 	bool AfsFile::loadFromFile(const std::string& path)
 	{
+		mapping.close();
+		archive.close();
+
 		print(Level::LOG, "Creating File Stream..");
 		std::ifstream stream(path, std::ios::binary);
 		if (!stream.is_open())		 return false;
@@ -67,6 +172,47 @@ namespace afs
 		readFileTable(stream);
 		print(Level::LOG, "\tLoading AFS Info");
 		readDatInfo();
+		buildNameIndex();
+
+		return true;
+	}
+
+	bool AfsFile::mapFromFile(const std::string& path)
+	{
+		print(Level::LOG, "Mapping File..");
+		if (!mapping.open(path))	 return false;
+		if (!archive.open(path))	 return false;
+		if (mapping.size() < 8)		 return false;
+
+		imemstream stream(mapping.data(), mapping.size());
+		if (!validateHeader(stream)) return false;
+		print(Level::LOG, "\tFile Mapped And Verified!");
+
+		print(Level::LOG, "Parsing Contents");
+		getFileCount(stream);
+		if ((size_t(file_count.cast()) + 2) * 8 > mapping.size())
+		{
+			print(Level::ERROR, "\tFile Count Exceeds Bounds Of File: " + std::to_string(file_count.cast()));
+			return false;
+		}
+		print(Level::LOG, "\tAllocating Memory:");
+		allocateHeaderMemory();
+		print(Level::LOG, "\tReading TOC..");
+		readEntryHeaders(stream);
+		print(Level::LOG, "\tRetreiving File Table Metadata");
+		readFileTableHeader(stream);
+		print(Level::LOG, "\tMapping Files");
+		mapEntries();
+		if (mapping.view(file_table.offset.cast(), size_t(file_count.cast()) * ENTRY_SIZE).empty() && file_count.cast())
+		{
+			print(Level::ERROR, "\tFile Table Exceeds Bounds Of File: " + to_hex(file_table.offset.cast()));
+			return false;
+		}
+		print(Level::LOG, "\tLoading File Table Heirarchy");
+		readFileTable(stream);
+		print(Level::LOG, "\tLoading AFS Info");
+		readDatInfo();
+		buildNameIndex();
 
 		return true;
 	}
@@ -90,6 +236,7 @@ namespace afs
 		print(Level::VERBOSE, "\t\tClearing Any Potential Old Entries");
 		files.clear();
 		file_table.entries.clear();
+		duplicate_of.clear();
 
 		print(Level::VERBOSE, "\t\tResizing File Table, and TOC");
 		files.resize(file_count);
@@ -126,6 +273,16 @@ namespace afs
 		}
 	}
 
+	void AfsFile::mapEntries()
+	{
+		for (Entry& file : files)
+		{
+			file.view = mapping.view(file.offset.cast(), file.size.cast());
+			if (file.view.empty() && file.size.cast())
+				print(Level::ERROR, "\t\tEntry Exceeds Bounds Of File: " + to_hex(file.offset.cast()) + " [" + std::to_string(file.size.cast()) + "]");
+		}
+	}
+
 	void AfsFile::readFileTable(std::istream& stream)
 	{
 		stream.seekg(file_table.offset.cast());
@@ -166,7 +323,44 @@ namespace afs
 
 	void AfsFile::readDatInfo()
 	{
-		datInfo.load(files[0].rawData, file_count);
+		datInfo.load(files[0].data(), file_count);
+	}
+
+	size_t AfsFile::size()
+	{
+		return files.size();
+	}
+
+	ByteView AfsFile::getData(const size_t& index)
+	{
+		if (index >= files.size()) return {};
+		return files[index].data();
+	}
+
+	uint32_t AfsFile::entryOffset(const size_t& index)
+	{
+		if (index >= files.size()) return 0;
+		return files[index].offset.cast();
+	}
+
+	std::string AfsFile::entryName(const size_t& index)
+	{
+		if (index < datInfo.size() && !datInfo[index].filename.empty() && datInfo[index].filename != "_")
+			return std::string(datInfo[index].filename);
+		if (index < file_table.entries.size() && file_table.entries[index].filename.c_str()[0])
+			return file_table.entries[index].filename.c_str();
+		return std::to_string(index);
+	}
+
+	void AfsFile::hashEntries(thread_pool& pool, std::vector<uint64_t>& hashes)
+	{
+		hashes.assign(files.size(), 0);
+		for (size_t i = 0; i < files.size(); i++)
+			pool.push_task([this, &hashes, i]
+				{
+					ByteView data = files[i].data();
+					hashes[i] = hash::xxh64(data.data(), data.size());
+				});
 	}
 
 	std::vector<std::string> AfsFile::getFileNames()
@@ -177,7 +371,7 @@ namespace afs
 		return filenames;
 	}
 
-	std::vector<std::string> AfsFile::getFilePaths()
+	std::vector<std::string_view> AfsFile::getFilePaths()
 	{
 		return datInfo.getFilePaths();
 	}
@@ -203,20 +397,88 @@ namespace afs
 		return;
 	}
 
-	void AfsFile::calculateOffsets()
+	void AfsFile::calculateOffsets(const std::vector<size_t>& trace)
 	{
 		uint32_t starting_offset = ((file_count + 2) * 8);
-		for (auto& entry : files)
+		for (const size_t& i : physicalOrder(trace))
 		{
+			Entry& entry = files[i];
 			starting_offset = Interface::allign(starting_offset, BLOCK_ALLIGNMENT);
 			entry.offset = starting_offset;
 			starting_offset += entry.size;
 		}
+		for (size_t i = 0; i < duplicate_of.size() && i < files.size(); i++)		// Duplicates share their original's slot
+			if (duplicate_of[i] != i) files[i].offset = files[duplicate_of[i]].offset;
 		starting_offset = Interface::allign(starting_offset, BLOCK_ALLIGNMENT);
 		file_table.offset = starting_offset;
 		file_table.size = file_count * ENTRY_SIZE;
 	}
 
+	std::vector<size_t> AfsFile::physicalOrder(const std::vector<size_t>& trace)
+	{
+		std::vector<size_t> order;
+		std::vector<char>	placed(files.size());
+		order.reserve(files.size());
+
+		auto place = [&](size_t index)
+		{
+			if (index < duplicate_of.size()) index = duplicate_of[index];
+			if (index >= files.size() || placed[index]) return;
+			placed[index] = true;
+			order.push_back(index);
+		};
+
+		// afsinfo always leads. Traced entries follow in first load order, then everything else in index order
+		place(0);
+		for (const size_t& index : trace)
+			place(index);
+		for (size_t i = 0; i < files.size(); i++)
+			place(i);
+		return order;
+	}
+
+	std::vector<size_t> AfsFile::loadTrace(const std::string& path)
+	{
+		std::vector<size_t> trace;
+		std::ifstream stream(path);
+		if (!stream.is_open()) { print(Level::ERROR, "\tUnable To Open Trace: " + path); return trace; }
+
+		size_t unknown{};
+		for (std::string line; std::getline(stream, line);)
+		{
+			line = line.substr(0, line.find_last_not_of("\r ") + 1);
+			if (line.empty()) continue;
+
+			// An index too large to parse is skipped like any other unknown entry
+			size_t index{ SIZE_MAX };
+			if (line.find_first_not_of("0123456789") != std::string::npos) index = indexFromName(line);
+			else if (std::from_chars(line.data(), line.data() + line.size(), index).ec != std::errc()) index = SIZE_MAX;
+			if (index < files.size()) trace.push_back(index);
+			else					  unknown++;
+		}
+
+		if (unknown) print(Level::ERROR, "\tSkipped " + std::to_string(unknown) + " Unknown Trace Entries");
+		return trace;
+	}
+
+	std::pair<size_t, uint64_t> AfsFile::traceCost(const std::vector<size_t>& trace)
+	{
+		// Models a drive reading each traced entry in turn. Every read that does not start where the previous one ended is a seek
+		size_t	 seeks{};
+		uint64_t distance{}, head{};
+		for (const size_t& index : trace)
+		{
+			uint64_t start = files[index].offset.cast() / BLOCK_ALLIGNMENT;
+			if (start != head)
+			{
+				seeks++;
+				distance += start > head ? start - head : head - start;
+			}
+			head = Interface::allign(files[index].offset.cast() + files[index].size.cast(), BLOCK_ALLIGNMENT) / BLOCK_ALLIGNMENT;
+		}
+		return { seeks, distance };
+	}
+
 	void AfsFile::writeFile(const std::string& path)
 	{
 		std::ofstream stream(path, std::ios::binary);
@@ -237,18 +499,123 @@ namespace afs
 		stream << le_uint32_t(static_cast<uint32_t>(files.size()));
 	}
 
-	void AfsFile::readFilesToEntries(const std::string& path)
+	void AfsFile::readFileSizes()
 	{
 		for (uint32_t i = 1; i < file_count; i ++)
-		{
 			files[i].size = datInfo[i].size;
-			files[i].rawData.resize(datInfo[i].size);
+	}
+
+	ByteArray AfsFile::readSource(const std::string& source, const size_t& index)
+	{
+		NativeFile in(source + "/" + std::string(datInfo[index].filename));
+		ByteArray  ret(files[index].size.cast());
+		if (!in.read(0, ret.data(), ret.size())) return {};
+		return ret;
+	}
 
-			std::ifstream stream(path + "/" + datInfo[i].filename, std::ios::binary);
-			stream.read((char*)files[i].rawData.data(), datInfo[i].size);
-			stream.close();
+	void AfsFile::streamEntries(const std::string& source, const std::string& path)
+	{
+		NativeFile out(path, NativeFile::Mode::MODIFY);
+		if (!out.is_open()) { print(Level::ERROR, "\tUnable To Open Output File: " + path); return; }
+
+		std::vector<uint32_t> order;
+		for (uint32_t i = 1; i < file_count; i++)
+			if (files[i].size.cast() && (i >= duplicate_of.size() || duplicate_of[i] == i)) order.push_back(i);
+		std::sort(order.begin(), order.end(), [this](const uint32_t& a, const uint32_t& b) { return files[a].offset.cast() < files[b].offset.cast(); });
+
+		// Readers run ahead of a single writer that consumes them in disc order. Every slot is precomputed,
+		// so the output matches a serial build byte for byte. Read ahead is capped by count and by bytes,
+		// and entries over the byte cap are never buffered: the writer copies them through in chunks
+		thread_pool pool;
+		const size_t window = static_cast<size_t>(pool.get_thread_count()) * 2;
+		std::deque<std::future<ByteArray>> in_flight;
+		uint64_t buffered{};
+		size_t	 next{};
+
+		for (const uint32_t& i : order)
+		{
+			for (; next < order.size(); next++)
+			{
+				uint64_t size = files[order[next]].size.cast();
+				if (size > MAX_IN_FLIGHT) continue;
+				if (!in_flight.empty() && (in_flight.size() >= window || buffered + size > MAX_IN_FLIGHT)) break;
+
+				buffered += size;
+				in_flight.push_back(pool.submit([this, &source](const uint32_t& index) { return readSource(source, index); }, order[next]));
+			}
+
+			std::string name(datInfo[i].filename);
+			print(Level::VERBOSE, "\t\t" + name + " -> " + to_hex(files[i].offset.cast()));
+			if (files[i].size.cast() > MAX_IN_FLIGHT)
+			{
+				NativeFile in(source + "/" + name);
+				if (!in.is_open() || in.size() < files[i].size.cast() || !NativeFile::copy(in, 0, out, files[i].offset.cast(), files[i].size.cast()))
+					print(Level::ERROR, "\tUnable To Stream Entry: " + name);
+				continue;
+			}
+
+			ByteArray data = in_flight.front().get();
+			in_flight.pop_front();
+			buffered -= files[i].size.cast();
+
+			if (data.size() != files[i].size.cast() || !out.write(files[i].offset.cast(), data.data(), data.size()))
+				print(Level::ERROR, "\tUnable To Stream Entry: " + name);
 		}
-		return;
+	}
+
+	uint64_t AfsFile::findDuplicates(const std::string& source)
+	{
+		duplicate_of.resize(files.size());
+		for (size_t i = 0; i < duplicate_of.size(); i++)
+			duplicate_of[i] = i;
+
+		print(Level::LOG, "\tHashing " + std::to_string(file_count - 1) + " Files");
+		std::vector<uint64_t> hashes(files.size());
+		thread_pool pool;
+		for (uint32_t i = 1; i < file_count; i++)
+		{
+			if (!files[i].size.cast()) continue;
+			pool.push_task([this, &source, &hashes, i]
+				{
+					MappedFile in(source + "/" + std::string(datInfo[i].filename));
+					ByteView   data = in.view(0, files[i].size.cast());
+					hashes[i] = hash::xxh64(data.data(), data.size());
+				});
+		}
+		pool.wait_for_tasks();
+
+		// Walk in index order so every duplicate points back at the first copy, which always gets laid out first
+		uint64_t saved{}, count{};
+		std::unordered_map<uint64_t, std::vector<size_t>> buckets;
+		for (uint32_t i = 1; i < file_count; i++)
+		{
+			if (!files[i].size.cast()) continue;
+
+			auto& bucket = buckets[hashes[i]];
+			for (const size_t& original : bucket)
+				if (files[original].size.cast() == files[i].size.cast() && sameContents(source + "/" + std::string(datInfo[original].filename), source + "/" + std::string(datInfo[i].filename), files[i].size.cast()))
+				{
+					duplicate_of[i] = original;
+					break;
+				}
+
+			if (duplicate_of[i] == i) { bucket.push_back(i); continue; }
+
+			print(Level::VERBOSE, "\t\t" + std::string(datInfo[i].filename) + " = " + std::string(datInfo[duplicate_of[i]].filename));
+			saved += Interface::allign(files[i].size.cast(), BLOCK_ALLIGNMENT);
+			count++;
+		}
+
+		print(Level::LOG, "\tDeduplicated " + std::to_string(count) + " Entries. Saved " + std::to_string(saved) + " Bytes");
+		return saved;
+	}
+
+	bool AfsFile::sameContents(const std::string& lhs, const std::string& rhs, const uint32_t& size)
+	{
+		MappedFile a(lhs), b(rhs);
+		ByteView left = a.view(0, size), right = b.view(0, size);
+		if (left.size() != size || right.size() != size) return false;
+		return std::memcmp(left.data(), right.data(), size) == 0;
 	}
 
 	void AfsFile::writeEntryHeaders(std::ostream& stream)
@@ -268,8 +635,9 @@ namespace afs
 	{
 		for (auto& entry : files)
 		{
+			ByteView data = entry.data();
 			stream.seekp(entry.offset.cast());
-			stream.write((char*)entry.rawData.data(), entry.size);
+			stream.write((char*)data.data(), data.size());
 		}
 	}
 
@@ -285,15 +653,37 @@ namespace afs
 		stream << le_int32_t{};
 	}
 
-	void AfsFile::buildAfs(const std::string& path, const std::string& out)
+	void AfsFile::buildAfs(const std::string& path, const std::string& out, const bool& deduplicate, const std::string& trace)
 	{
+		print(Level::LOG, "\tGathering File Sizes");
 		buildAfsInfo(path);
 		allocateHeaderMemory();
 		generateAfsInfo();
-		readFilesToEntries(path);
+		readFileSizes();
+		if (deduplicate)
+		{
+			print(Level::LOG, "\tFinding Duplicate Files");
+			findDuplicates(path);
+		}
+		print(Level::LOG, "\tCalculating Layout");
 		buildFileTable();
 		calculateOffsets();
-		writeFile(out);
+		if (!trace.empty())
+		{
+			buildNameIndex();
+			std::vector<size_t> accesses = loadTrace(trace);
+			auto [seeks, distance] = traceCost(accesses);
+			calculateOffsets(accesses);
+			auto [traced_seeks, traced_distance] = traceCost(accesses);
+
+			print(Level::LOG, "\tLaid Out " + std::to_string(accesses.size()) + " Traced Loads");
+			print(Level::LOG, "\t\tSeeks: " + std::to_string(seeks) + " -> " + std::to_string(traced_seeks));
+			print(Level::LOG, "\t\tSeek Distance: " + std::to_string(distance) + " -> " + std::to_string(traced_distance) + " Sectors");
+		}
+		print(Level::LOG, "\tWriting TOC And File Table");
+		writeFile(out);															// Only afsinfo is in memory. Every other slot is left as a hole
+		print(Level::LOG, "\tStreaming Files Into Place");
+		streamEntries(path, out);
 	}
 
 	void AfsFile::save(const std::string& path)
@@ -302,4 +692,116 @@ namespace afs
 		calculateOffsets();
 		writeFile(path);
 	}
+
+	void AfsFile::unmap()
+	{
+		for (Entry& file : files)
+			file.view = {};
+		mapping.close();
+		archive.close();
+	}
+
+	uint32_t AfsFile::slotCapacity(const size_t& index)
+	{
+		uint32_t start = files[index].offset.cast();
+		uint32_t end   = Interface::allign(start + files[index].size.cast(), BLOCK_ALLIGNMENT);
+
+		// A slot shared with (or overlapped by) another entry can't be rewritten without corrupting it
+		for (size_t i = 0; i < files.size(); i++)
+		{
+			if (i == index || files[i].size.cast() == 0) continue;
+			uint32_t other = files[i].offset.cast();
+			if (other < end && start < other + files[i].size.cast()) return 0;
+		}
+		return end - start;
+	}
+
+	bool AfsFile::writeZeros(const NativeFile& stream, uint64_t offset, uint64_t count)
+	{
+		static const ByteArray zeros(BLOCK_ALLIGNMENT);
+		while (count)
+		{
+			size_t chunk = static_cast<size_t>(std::min<uint64_t>(count, zeros.size()));
+			if (!stream.write(offset, zeros.data(), chunk)) return false;
+			offset += chunk; count -= chunk;
+		}
+		return true;
+	}
+
+	bool AfsFile::writeRecords(const NativeFile& stream, const size_t& index)
+	{
+		Entry& file = files[index];
+		bool ok = stream.write(8 + index * 8, file.offset.get(), 4)						// TOC
+			   && stream.write(12 + index * 8, file.size.get(), 4);
+
+		if (file_table.offset.cast() && index < file_table.entries.size())				// File table
+		{
+			file_table.entries[index].filesize = file.size.cast();
+			ok &= stream.write(file_table.offset.cast() + index * ENTRY_SIZE + 0x2C, file_table.entries[index].filesize.get(), 4);
+		}
+
+		if (index < datInfo.size() && files[0].size.cast())								// afsinfo size table
+		{
+			datInfo[index].size = file.size.cast();
+			size_t position = datInfo.sizeOffset(index);
+			if (position + 4 <= files[0].size.cast())
+				ok &= stream.write(files[0].offset.cast() + position, datInfo[index].size.get(), 4);
+		}
+		return ok;
+	}
+
+	bool AfsFile::patch(const std::string& path, const std::vector<std::pair<size_t, std::string>>& replacements)
+	{
+		unmap();																		// Views would go stale, and windows won't write to a mapped file
+
+		NativeFile stream(path, NativeFile::Mode::MODIFY);
+		if (!stream.is_open()) { print(Level::ERROR, "\tUnable To Open Archive For Writing: " + path); return false; }
+		uint64_t end = stream.size();
+
+		bool ok{ true };
+		for (const auto& [index, source] : replacements)
+		{
+			if (index == 0 || index >= files.size())
+			{
+				print(Level::ERROR, "\tInvalid Entry Index: " + std::to_string(index));
+				ok = false; continue;
+			}
+
+			NativeFile in(source);
+			if (!in.is_open() || in.size() > 0xffffffff)
+			{
+				print(Level::ERROR, "\tUnable To Read Replacement: " + source);
+				ok = false; continue;
+			}
+			uint32_t size	  = static_cast<uint32_t>(in.size());
+			uint32_t old_size = files[index].size.cast();
+			uint32_t capacity = slotCapacity(index);
+
+			if (capacity && size <= capacity)
+			{
+				print(Level::LOG, "\tPatching Entry " + std::to_string(index) + " In Place @ " + to_hex(files[index].offset.cast()));
+				ok &= NativeFile::copy(in, 0, stream, files[index].offset.cast(), size);
+				if (size < old_size) ok &= writeZeros(stream, files[index].offset.cast() + size, old_size - size);
+			}
+			else
+			{
+				uint64_t offset = Interface::allign(static_cast<uint32_t>(end), BLOCK_ALLIGNMENT);
+				if (offset + size > 0xffffffff)
+				{
+					print(Level::ERROR, "\tArchive Would Exceed 4GB: " + source);
+					ok = false; continue;
+				}
+				print(Level::LOG, "\tRelocating Entry " + std::to_string(index) + " To End Of Archive @ " + to_hex(static_cast<uint32_t>(offset)));
+				ok &= NativeFile::copy(in, 0, stream, offset, size);
+
+				end = Interface::allign(static_cast<uint32_t>(offset + size), BLOCK_ALLIGNMENT);
+				ok &= writeZeros(stream, offset + size, end - (offset + size));				// Keep the archive block alligned
+				files[index].offset = static_cast<uint32_t>(offset);
+			}
+
+			files[index].size = size;
+			ok &= writeRecords(stream, index);
+		}
+		return ok;
+	}
 }
@@ -2,16 +2,10 @@
 
 namespace dat
 {
-	std::string AfsInfo::readString(std::istream& stream)
-	{
-		std::string ret(0x100, '\0');
-		stream.getline(ret.data(), 0x100, 0xA);	// Explicate delim incase binary mode stream
-		return ret.substr(0, ret.find(0xD));		// Remove the special characters from end
-	}
-
 	void AfsInfo::clearMemory()
 	{
 		entries.clear();
+		arena.clear();
 	}
 
 	void AfsInfo::allocateMemory(const size_t& count)
@@ -19,31 +13,47 @@ namespace dat
 		entries.resize(count);
 	}
 
-	void AfsInfo::readEntries(std::istream& stream)
+	size_t AfsInfo::readStrings(ByteView data)
 	{
-		readStrings(stream);
-		readSizes(stream);
-	}
+		// Find where the CRLF separated block ends first so the arena is sized exactly once
+		const char* begin  = reinterpret_cast<const char*>(data.data());
+		size_t		cursor = 0;
+		for (size_t i = 0; i < entries.size() && cursor < data.size(); i++)
+		{
+			const void* newline = std::memchr(begin + cursor, 0xA, data.size() - cursor);
+			cursor = newline ? static_cast<const char*>(newline) - begin + 1 : data.size();
+		}
+		arena.assign(begin, begin + cursor);
 
-	void AfsInfo::readStrings(std::istream& stream)
-	{
+		size_t start = 0;
 		for (Entry& entry : entries)
-			entry.filename = readString(stream);
+		{
+			if (start >= arena.size()) break;
+			const void* newline = std::memchr(arena.data() + start, 0xA, arena.size() - start);
+			size_t end = newline ? static_cast<const char*>(newline) - arena.data() : arena.size();
+
+			std::string_view line(arena.data() + start, end - start);
+			entry.filename = line.substr(0, line.find(0xD));						// Remove the special characters from end
+			start = end + 1;
+		}
+		return cursor;
 	}
 
-	void AfsInfo::readSizes(std::istream& stream)
+	void AfsInfo::readSizes(ByteView data, size_t cursor)
 	{
 		for (Entry& entry : entries)
-			stream >> entry.size;
+		{
+			if (cursor + entry.size.size() > data.size()) break;
+			std::memcpy(&entry.size.data(), data.data() + cursor, entry.size.size());
+			cursor += entry.size.size();
+		}
 	}
 
-	void AfsInfo::load(const ByteArray& data, const size_t& count)
+	void AfsInfo::load(ByteView data, const size_t& count)
 	{
-		imemstream stream(data.data(), data.size());
-
 		clearMemory();
 		allocateMemory(count);
-		readEntries(stream);
+		readSizes(data, readStrings(data));
 	}
 
 	size_t AfsInfo::size()
@@ -58,9 +68,10 @@ namespace dat
 		return entries[index];
 	}
 
-	std::vector<std::string> AfsInfo::getFilePaths()
+	std::vector<std::string_view> AfsInfo::getFilePaths()
 	{
-		std::vector<std::string> filenames;
+		std::vector<std::string_view> filenames;
+		filenames.reserve(entries.size());
 		for (auto& file : entries)
 			filenames.push_back(file.filename);
 		return filenames;
@@ -73,15 +84,33 @@ namespace dat
 
 	void AfsInfo::build(const std::string& path)
 	{
-		entries.clear();
+		static const std::string_view AFSINFO{ "afsinfo.dat" };
+
+		clearMemory();
 
-		entries.push_back({ "afsinfo.dat", 0 });
+		std::vector<size_t> lengths{ AFSINFO.size() };
+		std::vector<uint32_t> sizes{ 0 };
+		std::string names{ AFSINFO };
 		for (const auto& entry : std::filesystem::recursive_directory_iterator(path))
 		{
 			if (std::filesystem::is_directory(entry.path())) continue;
-			std::cout << entry.path().string().substr(path.size() + 1) << " : " << std::filesystem::file_size(entry.path()) << std::endl;
+			std::string filename = entry.path().string().substr(path.size() + 1);
 			uint32_t filesize = static_cast<uint32_t>( std::filesystem::file_size( entry.path() ) );
-			entries.push_back({ entry.path().string().substr(path.size() + 1), filesize });
+			std::cout << filename << " : " << filesize << std::endl;
+
+			names += filename;
+			lengths.push_back(filename.size());
+			sizes.push_back(filesize);
+		}
+
+		// Views are bound only once every name is in the arena, so nothing is left pointing at a reallocated buffer
+		arena.assign(names.begin(), names.end());
+		allocateMemory(lengths.size());
+		size_t start = 0;
+		for (size_t i = 0; i < entries.size(); i++)
+		{
+			entries[i] = { std::string_view(arena.data() + start, lengths[i]), sizes[i] };
+			start += lengths[i];
 		}
 	}
 
@@ -93,28 +122,42 @@ namespace dat
 		return ret;
 	}
 
-	ByteArray AfsInfo::compile()
+	size_t AfsInfo::sizeOffset(const size_t& index)
 	{
-		ByteArray ret;
-		ret.resize(calculateSize());
+		size_t ret{ index * 4 };								// Sizes follow the CRLF separated string block
+		for (auto& entry : entries)
+			ret += entry.filename.size() + 2;
+		return ret;
+	}
 
-		omemstream stream(ret.data(), ret.size());
+	ByteArray AfsInfo::compile()
+	{
+		ByteArray ret(calculateSize());
 
-		writeStrings(stream);
-		writeSizes(stream);
+		writeSizes(writeStrings(ret.data()));
 
 		return ret;
 	}
 
-	void AfsInfo::writeStrings(std::ostream& stream)
+	std::byte* AfsInfo::writeStrings(std::byte* cursor)
 	{
 		for (auto& entry : entries)
-			stream << entry.filename << "\r\n";
+		{
+			std::memcpy(cursor, entry.filename.data(), entry.filename.size());
+			cursor += entry.filename.size();
+			*cursor++ = std::byte(0xD);
+			*cursor++ = std::byte(0xA);
+		}
+		return cursor;
 	}
 
-	void AfsInfo::writeSizes(std::ostream& stream)
+	std::byte* AfsInfo::writeSizes(std::byte* cursor)
 	{
 		for (auto& entry : entries)
-			stream << entry.size;
+		{
+			std::memcpy(cursor, entry.size.get(), entry.size.size());
+			cursor += entry.size.size();
+		}
+		return cursor;
 	}
-}
\ No newline at end of file
+}
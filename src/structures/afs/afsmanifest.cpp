@@ -0,0 +1,158 @@
+#include "structures/afsmanifest.h"
+
+namespace afs
+{
+	static std::string toHash(const uint64_t& value)
+	{
+		char buffer[17]{};
+		std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(value));
+		return buffer;
+	}
+
+	void AfsManifest::build(AfsFile& file)
+	{
+		std::vector<uint64_t> hashes;
+		{
+			thread_pool pool;
+			file.hashEntries(pool, hashes);
+			pool.wait_for_tasks();
+		}
+
+		entries.resize(file.size());
+		for (size_t i = 0; i < entries.size(); i++)
+			entries[i] = { file.entryOffset(i), static_cast<uint32_t>(file.getData(i).size()), hashes[i], file.entryName(i) };
+	}
+
+	bool AfsManifest::save(const std::string& path)
+	{
+		std::ofstream stream(path, std::ios::binary);
+		if (!stream.is_open()) return false;
+
+		stream << HEADER << " " << entries.size() << "\n";
+		for (size_t i = 0; i < entries.size(); i++)
+			stream << i << "," << entries[i].offset << "," << entries[i].size << "," << toHash(entries[i].hash) << "," << entries[i].name << "\n";
+		return stream.good();
+	}
+
+	bool AfsManifest::load(const std::string& path)
+	{
+		entries.clear();
+
+		std::ifstream stream(path, std::ios::binary);
+		if (!stream.is_open()) return false;
+
+		std::string line;
+		if (!std::getline(stream, line) || line.rfind(HEADER, 0) != 0)
+		{
+			print(Level::ERROR, "\tNot An AFS Manifest: " + path);
+			return false;
+		}
+
+		size_t number{ 1 };
+		while (std::getline(stream, line))
+		{
+			number++;
+			if (!line.empty() && line.back() == '\r') line.pop_back();
+			if (line.empty()) continue;
+			if (!parseLine(line))
+			{
+				print(Level::ERROR, "\tMalformed Manifest Line " + std::to_string(number) + ": " + line);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool AfsManifest::parseLine(const std::string& line)
+	{
+		// index,offset,size,hash,name. The name is last so it may contain commas
+		size_t fields[4]{}, cursor{};
+		for (size_t& field : fields)
+		{
+			cursor = line.find(',', cursor);
+			if (cursor == std::string::npos) return false;
+			field = cursor++;
+		}
+
+		try
+		{
+			size_t index = std::stoull(line.substr(0, fields[0]));
+			if (index != entries.size()) return false;
+
+			Entry entry;
+			entry.offset = static_cast<uint32_t>(std::stoul(line.substr(fields[0] + 1, fields[1] - fields[0] - 1)));
+			entry.size	 = static_cast<uint32_t>(std::stoul(line.substr(fields[1] + 1, fields[2] - fields[1] - 1)));
+			entry.hash	 = std::stoull(line.substr(fields[2] + 1, fields[3] - fields[2] - 1), nullptr, 16);
+			entry.name	 = line.substr(fields[3] + 1);
+			entries.push_back(std::move(entry));
+		}
+		catch (const std::exception&) { return false; }
+		return true;
+	}
+
+	std::vector<AfsManifest::Failure> AfsManifest::verify(AfsFile& file)
+	{
+		std::vector<Failure> failures;
+		if (file.size() != entries.size())
+			failures.push_back({ std::min(file.size(), entries.size()), "Entry Count " + std::to_string(file.size()) + " Expected " + std::to_string(entries.size()) });
+
+		std::vector<uint64_t> hashes;
+		{
+			thread_pool pool;
+			file.hashEntries(pool, hashes);
+			pool.wait_for_tasks();
+		}
+
+		for (size_t i = 0; i < entries.size() && i < file.size(); i++)
+		{
+			const Entry& entry = entries[i];
+			if (file.entryOffset(i) != entry.offset)
+				failures.push_back({ i, "Offset " + to_hex(file.entryOffset(i)) + " Expected " + to_hex(entry.offset) });
+			else if (file.getData(i).size() != entry.size)
+				failures.push_back({ i, "Size " + std::to_string(file.getData(i).size()) + " Expected " + std::to_string(entry.size) });
+			else if (hashes[i] != entry.hash)
+				failures.push_back({ i, "Hash " + toHash(hashes[i]) + " Expected " + toHash(entry.hash) });
+		}
+		return failures;
+	}
+
+	std::vector<AfsManifest::Failure> AfsManifest::verify(const std::string& directory)
+	{
+		static const uint64_t MISSING{ ~0ull };
+
+		// Only the entries extractAll writes can be in the directory
+		auto [first, last] = AfsFile::extractedRange(entries.size());
+
+		std::vector<uint64_t> sizes(entries.size(), MISSING), hashes(entries.size());
+		{
+			thread_pool pool;
+			for (size_t i = first; i < last; i++)
+				pool.push_task([this, &directory, &sizes, &hashes, i]
+					{
+						std::string path = directory + "/" + entries[i].name;
+						if (!std::filesystem::is_regular_file(path)) return;
+
+						MappedFile in(path);
+						if (!in.is_open()) return;
+						sizes[i]  = in.size();
+						hashes[i] = hash::xxh64(in.data(), in.size());
+					});
+			pool.wait_for_tasks();
+		}
+
+		std::vector<Failure> failures;
+		for (size_t i = first; i < last; i++)
+		{
+			const Entry& entry = entries[i];
+			if (sizes[i] == MISSING)
+			{
+				if (entry.size) failures.push_back({ i, "Missing" });		// Empty entries are skipped by afs-extract -i
+			}
+			else if (sizes[i] != entry.size)
+				failures.push_back({ i, "Size " + std::to_string(sizes[i]) + " Expected " + std::to_string(entry.size) });
+			else if (hashes[i] != entry.hash)
+				failures.push_back({ i, "Hash " + toHash(hashes[i]) + " Expected " + toHash(entry.hash) });
+		}
+		return failures;
+	}
+}
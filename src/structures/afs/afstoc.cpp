@@ -0,0 +1,79 @@
+#include "structures/afstoc.h"
+
+namespace afs
+{
+	bool AfsToc::load(const std::string& path)
+	{
+		offsets.clear();
+		sizes.clear();
+		names.clear();
+
+		NativeFile file(path);
+		if (!file.is_open()) return false;
+		filesize = file.size();
+
+		ByteArray header(HEADER_SIZE);
+		if (!file.read(0, header.data(), header.size())) return false;
+
+		imemstream stream(header.data(), header.size());
+		std::string signature(4, '\0');
+		le_uint32_t count{};
+		stream.read(signature.data(), 4);
+		stream >> count;
+		if (signature != std::string("AFS\0", 4)) return false;
+
+		print(Level::VERBOSE, "\tFile Count: " + std::to_string(count.cast()));
+		return readEntryHeaders(file, count.cast());
+	}
+
+	bool AfsToc::readEntryHeaders(const NativeFile& file, const uint32_t& count)
+	{
+		if (HEADER_SIZE + (uint64_t(count) + 1) * 8 > filesize)
+		{
+			print(Level::ERROR, "\tFile Count Exceeds Bounds Of File: " + std::to_string(count));
+			return false;
+		}
+
+		ByteArray toc((size_t(count) + 1) * 8);											// Entry records plus the file table record
+		if (!file.read(HEADER_SIZE, toc.data(), toc.size())) return false;
+
+		offsets.resize(count);
+		sizes.resize(count);
+		names.assign(count, {});
+
+		imemstream stream(toc.data(), toc.size());
+		le_uint32_t offset{}, size{};
+		for (uint32_t i = 0; i < count; i++)
+		{
+			stream >> offset >> size;
+			offsets[i] = offset.cast();
+			sizes[i]   = size.cast();
+		}
+
+		stream >> offset >> size;
+		readFileTable(file, offset.cast());
+		return true;
+	}
+
+	void AfsToc::readFileTable(const NativeFile& file, const uint32_t& offset)
+	{
+		const uint64_t length = uint64_t(names.size()) * ENTRY_SIZE;
+		if (!offset || offset + length > filesize)
+		{
+			print(Level::VERBOSE, "\tNo File Table");
+			return;
+		}
+
+		ByteArray table(static_cast<size_t>(length));
+		if (!file.read(offset, table.data(), table.size())) return;
+
+		for (size_t i = 0; i < names.size(); i++)
+			std::memcpy(names[i].data(), table.data() + i * ENTRY_SIZE, FILENAME_LENGTH);
+	}
+
+	std::string_view AfsToc::name(const size_t& index) const
+	{
+		const auto& name = names[index];
+		return { name.data(), strnlen(name.data(), name.size()) };
+	}
+}
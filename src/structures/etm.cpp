@@ -102,6 +102,14 @@ namespace etm
 		loadEntries(stream);
 	}
 
+	void EtmFile::loadFromMemory(ByteView data)
+	{
+		imemstream stream(data.data(), data.size());
+
+		readHeader(stream);
+		loadEntries(stream);
+	}
+
 	void EtmFile::saveToFile(const std::string& path)
 	{
 		Interface::createSavePath(path);
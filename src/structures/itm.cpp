@@ -13,6 +13,19 @@ namespace itm
 		if (!stream.is_open()) return;
 
 		getFileSize(stream);
+		loadFromStream(stream);
+	}
+
+	void ItmFile::loadFromMemory(ByteView data)
+	{
+		imemstream stream(data.data(), data.size());
+
+		filesize = data.size();
+		loadFromStream(stream);
+	}
+
+	void ItmFile::loadFromStream(std::istream& stream)
+	{
 		uint32_t count = getFileCount(stream);
 		if (count)
 		{
@@ -157,15 +170,21 @@ namespace itm
 		auto directory_path = std::filesystem::path(path).parent_path();
 		if (!directory_path.empty())
 			std::filesystem::create_directories(directory_path);
-		for (int i = 0; i < entries.size(); i++)
+		for (size_t i = 0; i < entries.size(); i++)
 			entries[i].tpl.save(path + "/" + std::to_string(entries[i].id) + ".TPL");
 	}
 
+	void ItmFile::decompileTpls(const std::string& path)
+	{
+		for (size_t i = 0; i < entries.size(); i++)
+			entries[i].tpl.decompileAll(path + "/" + std::to_string(entries[i].id) + "/");
+	}
+
 	void ItmFile::extractBins(const std::string& path)
 	{
 		if (!std::filesystem::exists(path))
 			std::filesystem::create_directory(path);
-		for (int i = 0; i < entries.size(); i++)
+		for (size_t i = 0; i < entries.size(); i++)
 		{
 			std::ofstream stream(path + "/" + std::to_string(entries[i].id) + ".bin", std::ios::binary);
 			stream.write((char*)entries[i].bin.data(), entries[i].bin.size());
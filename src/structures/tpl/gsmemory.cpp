@@ -0,0 +1,142 @@
+#include "structures/gsmemory.h"
+
+#include <map>
+#include <mutex>
+#include <tuple>
+
+namespace gs
+{
+	static const uint8_t BLOCKS_32[4][8]{							// PSMCT32 and PSMT8 share the block arrangement
+		{  0,  1,  4,  5, 16, 17, 20, 21 },
+		{  2,  3,  6,  7, 18, 19, 22, 23 },
+		{  8,  9, 12, 13, 24, 25, 28, 29 },
+		{ 10, 11, 14, 15, 26, 27, 30, 31 }
+	};
+	static const uint8_t BLOCKS_4[8][4]{
+		{  0,  2,  8, 10 },
+		{  1,  3,  9, 11 },
+		{  4,  6, 12, 14 },
+		{  5,  7, 13, 15 },
+		{ 16, 18, 24, 26 },
+		{ 17, 19, 25, 27 },
+		{ 20, 22, 28, 30 },
+		{ 21, 23, 29, 31 }
+	};
+	static const uint8_t COLUMN_WORDS[2][8]{						// Words of an 8x2 PSMCT32 column
+		{ 0, 1, 4, 5,  8,  9, 12, 13 },
+		{ 2, 3, 6, 7, 10, 11, 14, 15 }
+	};
+
+	struct Layout
+	{
+		uint32_t	   pageWidth, pageHeight;
+		uint32_t	   blockWidth, blockHeight;
+		uint32_t	   blockColumns;
+		const uint8_t* blocks;
+	};
+
+	static const Layout PSMCT32_LAYOUT{  64,  32,  8,  8, 8, &BLOCKS_32[0][0] };
+	static const Layout PSMT8_LAYOUT  { 128,  64, 16, 16, 8, &BLOCKS_32[0][0] };
+	static const Layout PSMT4_LAYOUT  { 128, 128, 32, 16, 4, &BLOCKS_4[0][0]  };
+
+	// Each page holds 32 blocks of 4 columns, and each column is 16 words
+	static uint32_t columnAddress(const Layout& layout, const uint32_t& x, const uint32_t& y, const uint32_t& width)
+	{
+		uint32_t pagesPerRow = (width + layout.pageWidth - 1) / layout.pageWidth;
+		uint32_t page	= (y / layout.pageHeight) * pagesPerRow + x / layout.pageWidth;
+		uint32_t block	= layout.blocks[((y % layout.pageHeight) / layout.blockHeight) * layout.blockColumns + (x % layout.pageWidth) / layout.blockWidth];
+		uint32_t column = (y % layout.blockHeight) / (layout.blockHeight / 4);
+		return ((page * 32 + block) * 4 + column) * 16;
+	}
+
+	// Indexed columns are 4 rows tall. Rows 2 and 3 take the odd bytes (or nibbles) of each word, and every other column is rotated by 4 words
+	static std::pair<uint32_t, uint32_t> indexedAddress(const Layout& layout, const uint32_t& x, const uint32_t& y, const uint32_t& width)
+	{
+		uint32_t row	= y & 3, column = (y % layout.blockHeight) / 4, cx = x % layout.blockWidth;
+		uint32_t rotate = (((row >> 1) ^ (column & 1)) * 4);
+		uint32_t word	= columnAddress(layout, x, y, width) + COLUMN_WORDS[row & 1][(cx + rotate) & 7];
+		return { word, (cx >> 3) * 2 + (row >> 1) };
+	}
+
+	// Maps the texture onto one PSMCT32 upload rectangle. Null unless every texel lands on its own uploaded byte or nibble,
+	// so only permutations are ever cached
+	static std::shared_ptr<const SwizzleTable> buildTable(const Format& format, const uint32_t& width, const uint32_t& height, const uint32_t& uploadWidth, const uint32_t& uploadHeight)
+	{
+		const Layout&  layout  = format == Format::PSMT8 ? PSMT8_LAYOUT : PSMT4_LAYOUT;
+		const uint32_t perWord = format == Format::PSMT8 ? 4 : 8;
+
+		size_t pages = size_t((uploadWidth + 63) / 64) * ((uploadHeight + 31) / 32);
+		std::vector<int64_t> words(pages * 2048, -1);
+		for (uint32_t y = 0; y < uploadHeight; y++)
+			for (uint32_t x = 0; x < uploadWidth; x++)
+				words[columnAddress(PSMCT32_LAYOUT, x, y, uploadWidth) + COLUMN_WORDS[y & 1][x & 7]] = int64_t(y) * uploadWidth + x;
+
+		auto table = std::make_shared<SwizzleTable>(size_t(width) * height);
+		std::vector<bool> seen(table->size());
+		for (uint32_t y = 0; y < height; y++)
+			for (uint32_t x = 0; x < width; x++)
+			{
+				auto [word, unit] = indexedAddress(layout, x, y, width);
+				if (word >= words.size() || words[word] < 0) return nullptr;
+
+				size_t target = size_t(words[word]) * perWord + unit;
+				if (target >= seen.size() || seen[target]) return nullptr;
+				seen[target] = true;
+				(*table)[size_t(y) * width + x] = uint32_t(target);
+			}
+		return table;
+	}
+
+	// Data is usually uploaded as PSMCT32 at half the width, and half (PSMT8) or a quarter (PSMT4) of the height. That only covers the same
+	// blocks when the texture fills whole pages, so other sizes use the rectangle that does, as tested from the widest power of two down.
+	// PSMT4 textures smaller than a block (32x16) match no rectangle and stay unsupported
+	static std::shared_ptr<const SwizzleTable> buildTable(const Format& format, const uint32_t& width, const uint32_t& height)
+	{
+		const uint32_t perWord = format == Format::PSMT8 ? 4 : 8;
+		if (!width || !height || (size_t(width) * height) % perWord) return nullptr;
+		const size_t words = size_t(width) * height / perWord;
+
+		if (width % 2 == 0 && height % (perWord / 2) == 0)
+			if (auto table = buildTable(format, width, height, width / 2, height / (perWord / 2)))
+				return table;
+
+		for (uint32_t uploadWidth = 2048; uploadWidth; uploadWidth /= 2)
+			if (words % uploadWidth == 0 && uploadWidth != width / 2)
+				if (auto table = buildTable(format, width, height, uploadWidth, uint32_t(words / uploadWidth)))
+					return table;
+		return nullptr;
+	}
+
+	std::shared_ptr<const SwizzleTable> swizzleTable(const Format& format, const uint32_t& width, const uint32_t& height)
+	{
+		static std::mutex lock;
+		static std::map<std::tuple<Format, uint32_t, uint32_t>, std::shared_ptr<const SwizzleTable>> cache;
+
+		std::lock_guard<std::mutex> guard(lock);
+		auto key = std::make_tuple(format, width, height);
+		if (auto found = cache.find(key); found != cache.end()) return found->second;
+		return cache[key] = buildTable(format, width, height);		// Unsupported sizes are cached as well
+	}
+
+	bool unswizzle(const Format& format, const uint32_t& width, const uint32_t& height, const unsigned char* in, unsigned char* out)
+	{
+		auto table = swizzleTable(format, width, height);
+		if (!table) return false;
+
+		const uint32_t* source = table->data();
+		for (size_t i = 0, count = table->size(); i < count; i++)
+			out[i] = in[source[i]];
+		return true;
+	}
+
+	bool swizzle(const Format& format, const uint32_t& width, const uint32_t& height, const unsigned char* in, unsigned char* out)
+	{
+		auto table = swizzleTable(format, width, height);
+		if (!table) return false;
+
+		const uint32_t* destination = table->data();
+		for (size_t i = 0, count = table->size(); i < count; i++)
+			out[destination[i]] = in[i];
+		return true;
+	}
+}
@@ -0,0 +1,156 @@
+#include "structures/tpl.h"
+
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TPL_DECODE_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TPL_TARGET_AVX2
+#else
+#define TPL_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace tpl
+{
+	static inline uint32_t normalize(const Interface::Color& color)
+	{
+		const unsigned char bytes[4]{ color.r, color.g, color.b, static_cast<unsigned char>(std::min(color.a * 2, 0xff)) };
+		uint32_t texel;
+		std::memcpy(&texel, bytes, sizeof(texel));
+		return texel;
+	}
+
+#ifdef TPL_DECODE_X86
+	static bool hasAVX2()
+	{
+#ifdef _MSC_VER
+		int info[4]{};
+		__cpuid(info, 0);
+		if (info[0] < 7) return false;
+		__cpuid(info, 1);
+		if (!(info[2] & (1 << 27)) || !(info[2] & (1 << 28))) return false;		// OSXSAVE and AVX
+		if ((_xgetbv(0) & 0x6) != 0x6) return false;							// YMM state enabled by the OS
+		__cpuidex(info, 7, 0);
+		return info[1] & (1 << 5);
+#else
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+
+	static const bool AVX2_SUPPORTED = hasAVX2();
+
+	// Alpha lanes are added to themselves with unsigned saturation, which is min(a * 2, 0xff)
+	static size_t normalizeSSE2(const Interface::Color* colors, const size_t& count, uint32_t* out)
+	{
+		const __m128i alpha = _mm_set1_epi32(int(0xff000000));
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i texels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(colors + i));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_adds_epu8(texels, _mm_and_si128(texels, alpha)));
+		}
+		return i;
+	}
+
+	TPL_TARGET_AVX2 static size_t normalizeAVX2(const Interface::Color* colors, const size_t& count, uint32_t* out)
+	{
+		const __m256i alpha = _mm256_set1_epi32(int(0xff000000));
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256i texels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(colors + i));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_adds_epu8(texels, _mm256_and_si256(texels, alpha)));
+		}
+		return i;
+	}
+
+	// Eight indices are widened to 32-bit and looked up with a single gather
+	TPL_TARGET_AVX2 static size_t expandAVX2(const unsigned char* indices, const size_t& count, const uint32_t* table, uint32_t* out)
+	{
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256i offsets = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(indices + i)));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_i32gather_epi32(reinterpret_cast<const int*>(table), offsets, 4));
+		}
+		return i;
+	}
+
+	// Even and odd indices sit in the low and high byte of each 16-bit lane. The sum is masked so it wraps like the byte arithmetic it replaces
+	static size_t packSSE2(const unsigned char* indices, const size_t& count, unsigned char* out)
+	{
+		const __m128i low = _mm_set1_epi16(0x00ff);
+		size_t i = 0;
+		for (; i + 32 <= count; i += 32)
+		{
+			__m128i first  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i));
+			__m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i + 16));
+			first  = _mm_and_si128(_mm_add_epi16(_mm_and_si128(first, low),  _mm_slli_epi16(_mm_srli_epi16(first, 8), 4)),  low);
+			second = _mm_and_si128(_mm_add_epi16(_mm_and_si128(second, low), _mm_slli_epi16(_mm_srli_epi16(second, 8), 4)), low);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i / 2), _mm_packus_epi16(first, second));
+		}
+		return i;
+	}
+
+	// Red and blue swap places; green and alpha stay where they are
+	static size_t storeSSE2(const Interface::Color* colors, const size_t& count, std::byte* out)
+	{
+		const __m128i greenAlpha = _mm_set1_epi32(int(0xff00ff00)), channel = _mm_set1_epi32(0xff);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i texels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(colors + i));
+			__m128i red	   = _mm_slli_epi32(_mm_and_si128(texels, channel), 16);
+			__m128i blue   = _mm_and_si128(_mm_srli_epi32(texels, 16), channel);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 4), _mm_or_si128(_mm_and_si128(texels, greenAlpha), _mm_or_si128(red, blue)));
+		}
+		return i;
+	}
+#endif
+
+	void normalizeColors(const Interface::Color* colors, const size_t& count, uint32_t* out)
+	{
+		size_t i = 0;
+#ifdef TPL_DECODE_X86
+		i = AVX2_SUPPORTED ? normalizeAVX2(colors, count, out) : normalizeSSE2(colors, count, out);
+#endif
+		for (; i < count; i++)
+			out[i] = normalize(colors[i]);
+	}
+
+	void expandIndices(const unsigned char* indices, const size_t& count, const uint32_t* table, uint32_t* out)
+	{
+		size_t i = 0;
+#ifdef TPL_DECODE_X86
+		if (AVX2_SUPPORTED) i = expandAVX2(indices, count, table, out);
+#endif
+		for (; i < count; i++)
+			out[i] = table[indices[i]];
+	}
+
+	void packIndices4(const unsigned char* indices, const size_t& count, unsigned char* out)
+	{
+		size_t i = 0;
+#ifdef TPL_DECODE_X86
+		i = packSSE2(indices, count, out);
+#endif
+		for (; i + 1 < count; i += 2)
+			out[i / 2] = static_cast<unsigned char>(indices[i + 1] * 0x10 + indices[i]);
+	}
+
+	void storeColors(const Interface::Color* colors, const size_t& count, std::byte* out)
+	{
+		size_t i = 0;
+#ifdef TPL_DECODE_X86
+		i = storeSSE2(colors, count, out);
+#endif
+		for (; i < count; i++)
+		{
+			const std::byte bytes[4]{ std::byte(colors[i].b), std::byte(colors[i].g), std::byte(colors[i].r), std::byte(colors[i].a) };
+			std::memcpy(out + i * 4, bytes, sizeof(bytes));
+		}
+	}
+}
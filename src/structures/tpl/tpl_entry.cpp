@@ -46,50 +46,39 @@ namespace tpl
 		stream.seekg(start_pos);
 	}
 
-	void Entry::saveTexture(std::ostream& stream, bool include_mips)
+	void Entry::saveTexture(ByteArray& file, const size_t& offset, bool include_mips)
 	{
 		print(Level::LOG, "\t\tWriting Container Header.");
-		writeTextureHeader(stream, include_mips);
+		writeTextureHeader(file, offset, include_mips);
 		print(Level::LOG, "\t\tWriting Container Data.");
-		writeTextureData(stream, include_mips);
+		writeTextureData(file, include_mips);
 	}
 
-	void Entry::writeTextureHeader(std::ostream& stream, bool include_mips)
+	void Entry::writeTextureHeader(ByteArray& file, const size_t& offset, bool include_mips)
 	{
-		texture.writeHeader(stream);
+		texture.writeHeader(file, offset);
 
-		auto start_pos = stream.tellp();
 		if (include_mips)
 		{
 			if (texture.hasMipmaps())
 			{
 				print(Level::LOG, "\t\t\t\tWriting Mipmap Header.");
-				for (int i = 0; i < texture.getMipmapCount(); i++) { stream.seekp(texture.getMipmapOffset(i)); mipmaps[i].writeHeader(stream, include_mips); }
+				for (int i = 0; i < texture.getMipmapCount(); i++) mipmaps[i].writeHeader(file, texture.getMipmapOffset(i), include_mips);
 			}
 		}
-
-		print(Level::VERBOSE, "\t\t\tSeeking To Starting Offset: " + std::to_string(start_pos));
-		stream.seekp(start_pos);
 	}
 
-	void Entry::writeTextureData(std::ostream& stream, bool include_mips)
+	void Entry::writeTextureData(ByteArray& file, bool include_mips)
 	{
-		auto start_pos = stream.tellp();
-
-		print(Level::VERBOSE, "\t\t\tSeeking Stream To Index Offset: " + std::to_string(texture.getIndexOffset()));
-		stream.seekp(texture.getIndexOffset());
-		print(Level::LOG, "\t\t\tWriting Texture Data To Stream.");
-		texture.writeData(stream);
+		print(Level::LOG, "\t\t\tWriting Texture Data At Index Offset: " + std::to_string(texture.getIndexOffset()));
+		texture.writeData(file);
 
 		if (include_mips)
 			if (texture.hasMipmaps())
 			{
 				print(Level::LOG, "\t\t\t\tWriting Mipmap Data.");
-				for (int i = 0; i < texture.getMipmapCount(); i++) { stream.seekp(mipmaps[i].getIndexOffset()); mipmaps[i].writeData(stream, true); }
+				for (int i = 0; i < texture.getMipmapCount(); i++) mipmaps[i].writeData(file, true);
 			}
-
-		print(Level::VERBOSE, "\t\t\tSeeking To Starting Offset: " + std::to_string(start_pos));
-		stream.seekp(start_pos);
 	}
 
 
@@ -113,4 +102,33 @@ namespace tpl
 	{ 
 		return texture.hasMipmaps(); 
 	}
+
+	uint32_t Entry::getDataSize(bool include_mips)
+	{
+		uint32_t ret = texture.getIndexSize() + (texture.hasPalette() ? texture.getPaletteSize() : 0);
+		if (include_mips && hasMipmaps())
+			for (auto& mipmap : mipmaps) ret += mipmap.getIndexSize();
+		return ret;
+	}
+
+	Requantization Entry::requantize(const CompileOptions& options, const double& maxError, thread_pool& pool)
+	{
+		Requantization ret;
+		if (texture.hasPalette()) return ret;
+
+		// Levels are converted on a copy so that a rejected entry is left untouched
+		Entry candidate = *this;
+		ret.error = candidate.texture.requantize(options, pool);
+		if (hasMipmaps())
+			for (auto& mipmap : candidate.mipmaps)
+				ret.error = std::max(ret.error, mipmap.requantize(options, pool, &candidate.texture));
+
+		ret.before = getDataSize();
+		ret.after  = candidate.getDataSize();
+		if (ret.error > maxError || ret.after >= ret.before) return ret;
+
+		*this = std::move(candidate);
+		ret.converted = true;
+		return ret;
+	}
 }
@@ -1,5 +1,7 @@
 #include "structures/tpl.h"
 
+#include <cstring>
+
 namespace tpl
 {
 	void TplFile::load(const std::string& path)
@@ -14,7 +16,7 @@ namespace tpl
 		loadEntries(stream);
 	}
 
-	void TplFile::loadFromMemory(const ByteArray& data)
+	void TplFile::loadFromMemory(ByteView data)
 	{
 		imemstream stream(data.data(), data.size());
 		if (!validateFile(stream))
@@ -65,15 +67,22 @@ namespace tpl
 		if (entries.size() == 0) return;
 
 		Interface::createSavePath(path);
-		std::ofstream stream(path, std::ios::binary);
-		if (!stream.is_open()) print(Level::EXCEPTION, EXCEPT_TEXT("Unable To Open Requested File: " + path));
+		ByteArray file = serialize();
 
-		calculateOffsets();
-		writeHeader(stream);
-		writeEntries(stream);
-	} 
+		NativeFile out(path, NativeFile::Mode::WRITE);
+		if (!out.is_open()) print(Level::EXCEPTION, EXCEPT_TEXT("Unable To Open Requested File: " + path));
+		if (!out.write(0, file.data(), file.size())) print(Level::ERROR, "\tUnable To Write TPL File: " + path);
+	}
+
+	ByteArray TplFile::serialize()
+	{
+		ByteArray file(calculateOffsets(), std::byte{ 0 });
+		writeHeader(file);
+		writeEntries(file);
+		return file;
+	}
 
-	void TplFile::calculateOffsets(bool include_mips)
+	uint32_t TplFile::calculateOffsets(bool include_mips)
 	{
 		std::vector<Entry*> entriesWithMipmaps;
 		uint32_t starting_offset = TPL_HEADER_SIZE;
@@ -115,17 +124,22 @@ namespace tpl
 			entry->getTexture().setMipmapOffset(1, mipmaps_starting_offset);
 			mipmaps_starting_offset += TPL_ENTRY_SIZE;
 		}
+		return starting_offset;
 	}
 
-	void TplFile::writeHeader(std::ostream& stream)
+	void TplFile::writeHeader(ByteArray& file)
 	{
-		stream << le_uint32_t(HEADER_GUARD) << le_uint32_t( static_cast<uint32_t>( entries.size() ) ) << le_uint64_t(0x10);
+		le_uint32_t guard(HEADER_GUARD), count(static_cast<uint32_t>(entries.size()));
+		le_uint64_t offset(0x10);
+		std::memcpy(file.data(),	 guard.get(),  guard.size());
+		std::memcpy(file.data() + 4, count.get(),  count.size());
+		std::memcpy(file.data() + 8, offset.get(), offset.size());
 	}
 
-	void TplFile::writeEntries(std::ostream& stream, bool include_mips)
+	void TplFile::writeEntries(ByteArray& file, bool include_mips)
 	{
-		for (auto& entry : entries)
-			entry.saveTexture(stream, include_mips);
+		for (size_t i = 0; i < entries.size(); i++)
+			entries[i].saveTexture(file, TPL_HEADER_SIZE + TPL_ENTRY_SIZE * i, include_mips);
 	}
 
 
@@ -168,9 +182,56 @@ namespace tpl
 		}
 	}
 
-	void TplFile::compile(const std::string& path)
+	bool TplFile::compile(const std::string& path, const CompileOptions& options)
+	{
+		std::vector<NumericFile> images;
+		for (auto& file : scanNumericDirectory(path))
+			if (StringToLower(file.extension) == ".tga") images.push_back(std::move(file));
+		if (images.empty())
+		{
+			print(Level::ERROR, "\tNo Numbered TGA Files Found In: " + path);
+			return false;
+		}
+
+		// Textures are compiled side by side, and each one spreads its own quantization over the same pool
+		entries.clear();
+		entries.resize(images.size(), { getLog() });
+		std::vector<char> compiled(images.size());
+
+		thread_pool pool;
+		for (size_t i = 0; i < images.size(); i++)
+			pool.push_task([this, &images, &compiled, &options, &pool, i]
+				{
+					print(Level::LOG, "\t\tCompiling: " + images[i].path);
+					compiled[i] = entries[i].getTexture().loadTGA(images[i].path, options, pool);
+				});
+		pool.wait_for_tasks();
+
+		return std::all_of(compiled.begin(), compiled.end(), [](const char& success) { return success; });
+	}
+
+	std::vector<Requantization> TplFile::requantize(const CompileOptions& options, const double& maxError, thread_pool& pool, const std::vector<std::pair<size_t, size_t>>& ranges)
 	{
+		std::vector<size_t> selected;
+		for (size_t i = 0; i < entries.size(); i++)
+			if (ranges.empty() || std::any_of(ranges.begin(), ranges.end(), [&i](const auto& range) { return i >= range.first && i <= range.second; }))
+				selected.push_back(i);
 
+		// ParallelFor rather than tasks, so whole files can be requantized from inside the same pool
+		std::vector<Requantization> results(entries.size());
+		ParallelFor(pool, selected.size(), [&](const size_t& i)
+			{
+				results[selected[i]] = entries[selected[i]].requantize(options, maxError, pool);
+			});
+
+		calculateOffsets();
+		return results;
+	}
+
+	std::vector<Requantization> TplFile::requantize(const CompileOptions& options, const double& maxError, const std::vector<std::pair<size_t, size_t>>& ranges)
+	{
+		thread_pool pool;
+		return requantize(options, maxError, pool, ranges);
 	}
 
 	TplFile& TplFile::operator += (TplFile& rhs)
@@ -0,0 +1,299 @@
+#include "structures/tpl.h"
+
+#include <array>
+#include <algorithm>
+
+namespace tpl
+{
+	struct Bucket
+	{
+		uint32_t color{};
+		uint32_t count{};
+	};
+
+	static inline uint32_t pack(const Interface::Color& color)
+	{
+		return uint32_t(color.r) | uint32_t(color.g) << 8 | uint32_t(color.b) << 16 | uint32_t(color.a) << 24;
+	}
+
+	static inline Interface::Color unpack(const uint32_t& value)
+	{
+		return { uint8_t(value), uint8_t(value >> 8), uint8_t(value >> 16), uint8_t(value >> 24) };
+	}
+
+	static inline uint8_t channel(const uint32_t& value, const int& index) { return uint8_t(value >> (index * 8)); }
+
+	// Colours are bucketed at 5 bits per channel for the search, and alpha at 4 of its 7 bits
+	static inline uint32_t reduce(const Interface::Color& color)
+	{
+		return uint32_t(color.r >> 3) | uint32_t(color.g >> 3) << 5 | uint32_t(color.b >> 3) << 10 | uint32_t(color.a >> 3) << 15;
+	}
+
+	// Alpha only reaches 0x80, so it is doubled to weigh the same as the colour channels
+	static inline uint32_t distance(const int& r, const int& g, const int& b, const int& a, const Interface::Color& rhs)
+	{
+		int dr = r - rhs.r, dg = g - rhs.g, db = b - rhs.b, da = (a - rhs.a) * 2;
+		return uint32_t(dr * dr + dg * dg + db * db + da * da);
+	}
+
+	static unsigned char nearest(const int& r, const int& g, const int& b, const int& a, const std::vector<Interface::Color>& palette)
+	{
+		size_t	 best{};
+		uint32_t bestDistance{ UINT32_MAX };
+		for (size_t i = 0; i < palette.size() && bestDistance; i++)
+		{
+			int dr = r - palette[i].r;
+			if (uint32_t(dr * dr) >= bestDistance) continue;				// Most entries are ruled out on the first channel
+
+			uint32_t d = distance(r, g, b, a, palette[i]);
+			if (d < bestDistance) { bestDistance = d; best = i; }
+		}
+		return static_cast<unsigned char>(best);
+	}
+
+	static unsigned char nearest(const uint32_t& color, const std::vector<Interface::Color>& palette)
+	{
+		return nearest(channel(color, 0), channel(color, 1), channel(color, 2), channel(color, 3), palette);
+	}
+
+	static std::vector<Interface::Color> medianCut(std::vector<Bucket> histogram, const size_t& colors)
+	{
+		struct Box
+		{
+			size_t begin, end;
+			int	   widest;
+			int	   range;
+		};
+
+		auto measure = [&histogram](const size_t& begin, const size_t& end)
+			{
+				Box box{ begin, end, 0, 0 };
+				for (int c = 0; c < 4; c++)
+				{
+					auto [low, high] = std::minmax_element(histogram.begin() + begin, histogram.begin() + end,
+						[c](const Bucket& lhs, const Bucket& rhs) { return channel(lhs.color, c) < channel(rhs.color, c); });
+					int range = (channel(high->color, c) - channel(low->color, c)) * (c == 3 ? 2 : 1);
+					if (range > box.range) { box.range = range; box.widest = c; }
+				}
+				return box;
+			};
+
+		// The box with the widest channel is split at its pixel weighted median until there are enough boxes
+		std::vector<Box> boxes{ measure(0, histogram.size()) };
+		while (boxes.size() < colors)
+		{
+			auto box = std::max_element(boxes.begin(), boxes.end(), [](const Box& lhs, const Box& rhs) { return lhs.range < rhs.range; });
+			if (box->range == 0) break;
+
+			int c = box->widest;
+			std::sort(histogram.begin() + box->begin, histogram.begin() + box->end,
+				[c](const Bucket& lhs, const Bucket& rhs) { return channel(lhs.color, c) < channel(rhs.color, c); });
+
+			uint64_t total{}, running{};
+			for (size_t i = box->begin; i < box->end; i++) total += histogram[i].count;
+
+			size_t split = box->begin + 1;
+			for (size_t i = box->begin; i < box->end - 1; i++)
+			{
+				running += histogram[i].count;
+				split = i + 1;
+				if (running * 2 >= total) break;
+			}
+
+			Box upper = measure(split, box->end);
+			*box = measure(box->begin, split);
+			boxes.push_back(upper);
+		}
+
+		std::vector<Interface::Color> palette;
+		for (const auto& box : boxes)
+		{
+			uint64_t sums[4]{}, count{};
+			for (size_t i = box.begin; i < box.end; i++)
+			{
+				for (int c = 0; c < 4; c++) sums[c] += uint64_t(channel(histogram[i].color, c)) * histogram[i].count;
+				count += histogram[i].count;
+			}
+			palette.push_back({ uint8_t(sums[0] / count), uint8_t(sums[1] / count), uint8_t(sums[2] / count), uint8_t(sums[3] / count) });
+		}
+		return palette;
+	}
+
+	// A few k-means passes move each entry to the mean of the colours that map to it. Chunks of the histogram accumulate separately
+	static void refine(const std::vector<Bucket>& histogram, std::vector<Interface::Color>& palette, thread_pool& pool, const int& passes = 4)
+	{
+		const size_t chunkSize = 0x1000, chunks = (histogram.size() + chunkSize - 1) / chunkSize;
+		std::vector<std::vector<std::array<uint64_t, 5>>> sums(chunks);
+
+		for (int pass = 0; pass < passes; pass++)
+		{
+			ParallelFor(pool, chunks, [&](const size_t& chunk)
+				{
+					auto& local = sums[chunk];
+					local.assign(palette.size(), {});
+					for (size_t i = chunk * chunkSize, end = std::min(histogram.size(), i + chunkSize); i < end; i++)
+					{
+						auto& sum = local[nearest(histogram[i].color, palette)];
+						for (int c = 0; c < 4; c++) sum[c] += uint64_t(channel(histogram[i].color, c)) * histogram[i].count;
+						sum[4] += histogram[i].count;
+					}
+				});
+
+			for (size_t p = 0; p < palette.size(); p++)
+			{
+				uint64_t total[5]{};
+				for (const auto& local : sums)
+					for (int c = 0; c < 5; c++) total[c] += local[p][c];
+				if (total[4])
+					palette[p] = { uint8_t(total[0] / total[4]), uint8_t(total[1] / total[4]), uint8_t(total[2] / total[4]), uint8_t(total[3] / total[4]) };
+			}
+		}
+	}
+
+	static double dither(const Interface::Color* pixels, const uint32_t& width, const uint32_t& height, const std::vector<Interface::Color>& palette, unsigned char* indices)
+	{
+		// Floyd-Steinberg error diffusion over two rows of RGBA error
+		std::vector<std::array<int, 4>> current(size_t(width) + 2), next(size_t(width) + 2);
+		double error{};
+
+		for (uint32_t y = 0; y < height; y++)
+		{
+			std::fill(next.begin(), next.end(), std::array<int, 4>{});
+			for (uint32_t x = 0; x < width; x++)
+			{
+				const Interface::Color& pixel = pixels[size_t(y) * width + x];
+				const auto& carried = current[x + 1];
+				int value[4]{
+					std::clamp(pixel.r + carried[0] / 16, 0, 0xff),
+					std::clamp(pixel.g + carried[1] / 16, 0, 0xff),
+					std::clamp(pixel.b + carried[2] / 16, 0, 0xff),
+					std::clamp(pixel.a + carried[3] / 16, 0, 0x80)
+				};
+
+				unsigned char index = nearest(value[0], value[1], value[2], value[3], palette);
+				indices[size_t(y) * width + x] = index;
+				error += distance(pixel.r, pixel.g, pixel.b, pixel.a, palette[index]);
+
+				const Interface::Color& chosen = palette[index];
+				int diff[4]{ value[0] - chosen.r, value[1] - chosen.g, value[2] - chosen.b, value[3] - chosen.a };
+				for (int c = 0; c < 4; c++)
+				{
+					current[x + 2][c] += diff[c] * 7;
+					next[x][c]		  += diff[c] * 3;
+					next[x + 1][c]	  += diff[c] * 5;
+					next[x + 2][c]	  += diff[c];
+				}
+			}
+			std::swap(current, next);
+		}
+		return error;
+	}
+
+	struct Histogram
+	{
+		std::vector<uint32_t> distinct{};								// Every colour present, sorted
+		std::vector<uint32_t> keys{};									// Reduced bucket keys, sorted
+		std::vector<Bucket>	  buckets{};								// Mean colour and pixel count of each bucket
+	};
+
+	// Sorting by bucket, then colour, gives both the distinct colours and the bucketed histogram in one pass
+	static Histogram buildHistogram(const Interface::Color* pixels, const size_t& count)
+	{
+		Histogram ret;
+		std::vector<uint64_t> keys(count);
+		for (size_t i = 0; i < count; i++) keys[i] = uint64_t(reduce(pixels[i])) << 32 | pack(pixels[i]);
+		std::sort(keys.begin(), keys.end());
+
+		uint64_t sums[4]{};
+		for (size_t i = 0, start = 0; i < count; i++)
+		{
+			uint32_t color = uint32_t(keys[i]), bucket = uint32_t(keys[i] >> 32);
+			if (i == 0 || keys[i - 1] != keys[i]) ret.distinct.push_back(color);
+			for (int c = 0; c < 4; c++) sums[c] += channel(color, c);
+
+			if (i + 1 == count || uint32_t(keys[i + 1] >> 32) != bucket)
+			{
+				uint32_t pixelCount = uint32_t(i + 1 - start);
+				ret.buckets.push_back({ pack({ uint8_t(sums[0] / pixelCount), uint8_t(sums[1] / pixelCount), uint8_t(sums[2] / pixelCount), uint8_t(sums[3] / pixelCount) }), pixelCount });
+				ret.keys.push_back(bucket);
+				std::fill(std::begin(sums), std::end(sums), 0);
+				start = i + 1;
+			}
+		}
+		std::sort(ret.distinct.begin(), ret.distinct.end());
+		return ret;
+	}
+
+	// Exact palettes are indexed through the distinct colours. Otherwise every bucket is matched once and rows are mapped through the bucket keys
+	static void assign(const Interface::Color* pixels, const uint32_t& width, const uint32_t& height, const Histogram& histogram, const bool& exact, const bool& dithered, Quantization& ret, thread_pool& pool)
+	{
+		const size_t count = size_t(width) * height;
+		if (dithered && !exact)
+		{
+			ret.error = dither(pixels, width, height, ret.palette, ret.indices.data()) / double(count);
+			return;
+		}
+
+		std::vector<unsigned char> lookup(exact ? 0 : histogram.buckets.size());
+		const size_t chunkSize = 0x1000;
+		ParallelFor(pool, (lookup.size() + chunkSize - 1) / chunkSize, [&](const size_t& chunk)
+			{
+				for (size_t i = chunk * chunkSize, end = std::min(lookup.size(), i + chunkSize); i < end; i++)
+					lookup[i] = nearest(histogram.buckets[i].color, ret.palette);
+			});
+
+		std::vector<double> rowError(height);
+		ParallelFor(pool, height, [&](const size_t& y)
+			{
+				for (size_t i = y * width, end = i + width; i < end; i++)
+				{
+					unsigned char index;
+					if (exact)
+						index = static_cast<unsigned char>(std::lower_bound(histogram.distinct.begin(), histogram.distinct.end(), pack(pixels[i])) - histogram.distinct.begin());
+					else
+						index = lookup[std::lower_bound(histogram.keys.begin(), histogram.keys.end(), reduce(pixels[i])) - histogram.keys.begin()];
+
+					ret.indices[i] = index;
+					rowError[y] += distance(pixels[i].r, pixels[i].g, pixels[i].b, pixels[i].a, ret.palette[index]);
+				}
+			});
+
+		ret.error = 0.0;
+		for (const auto& error : rowError) ret.error += error;
+		ret.error /= double(count);
+	}
+
+	Quantization quantize(const Interface::Color* pixels, const uint32_t& width, const uint32_t& height, const size_t& colors, const bool& dithered, thread_pool& pool)
+	{
+		Quantization ret;
+		const size_t count = size_t(width) * height;
+		ret.indices.resize(count);
+		if (!count || !colors) return ret;
+
+		// Textures that already fit are stored exactly. Otherwise the bucketed histogram is cut and refined
+		Histogram histogram = buildHistogram(pixels, count);
+		const bool exact = histogram.distinct.size() <= colors;
+		if (exact)
+			for (const auto& color : histogram.distinct) ret.palette.push_back(unpack(color));
+		else
+		{
+			ret.palette = medianCut(histogram.buckets, colors);
+			refine(histogram.buckets, ret.palette, pool);
+		}
+
+		assign(pixels, width, height, histogram, exact, dithered, ret, pool);
+		return ret;
+	}
+
+	Quantization remap(const Interface::Color* pixels, const uint32_t& width, const uint32_t& height, const std::vector<Interface::Color>& palette, const bool& dithered, thread_pool& pool)
+	{
+		Quantization ret;
+		const size_t count = size_t(width) * height;
+		ret.indices.resize(count);
+		ret.palette = palette;
+		if (!count || palette.empty()) return ret;
+
+		assign(pixels, width, height, buildHistogram(pixels, count), false, dithered, ret, pool);
+		return ret;
+	}
+}
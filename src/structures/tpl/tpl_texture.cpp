@@ -1,5 +1,9 @@
 #include "structures/tpl.h"
 
+#include <sstream>
+#include <cstring>
+#include <limits>
+
 namespace tpl
 {
 	void Texture::load(std::istream& stream, const uint32_t& palette_offset)
@@ -75,31 +79,36 @@ namespace tpl
 	}
 
 
-	void Texture::writeHeader(std::ostream& stream, bool mipmap)
+	void Texture::writeHeader(ByteArray& file, const size_t& offset, bool mipmap)
 	{
 		print(Level::LOG, "\t\t\tWriting Header.");
-		stream << header.width << header.height << header.bit_depth << header.interlacing
-			<< header.unknown << header.mipmap_count << header.upscaling
-			<< header.mipmap_offset[0] << header.mipmap_offset[1]
-			<< header.unknown2[0] << header.unknown2[1]
-			<< header.index_offset;
-		if (mipmap)
-			stream << ZERO;
-		else
-			stream << header.palette_offset;
-		stream << header.unknown3;			// Palette offset in mipmaps = 0
+		static_assert(sizeof(Header) == TPL_ENTRY_SIZE, "Texture headers are copied as they are stored");
+
+		Header out = header;
+		if (mipmap) out.palette_offset = 0;			// Palette offset in mipmaps = 0
+		if (std::byte* destination = reserve(file, offset, sizeof(out)))
+			std::memcpy(destination, &out, sizeof(out));
 	}
 
-	void Texture::writeData(std::ostream& stream, bool mipmap)
+	void Texture::writeData(ByteArray& file, bool mipmap)
 	{
 		print(Level::LOG, "\t\t\t\tWriting Indices.");
-		writeIndices(stream);
-		if (!mipmap)
+		writeIndices(file);
+		if (!mipmap || !hasPalette())									// 32-bit levels keep their texels in the palette, mipmaps included
 		{
 			print(Level::LOG, "\t\t\t\tWriting Palette.");
-			writePalette(stream);
+			writePalette(file);
+		}
+	}
+
+	std::byte* Texture::reserve(ByteArray& file, const size_t& offset, const size_t& count)
+	{
+		if (offset > file.size() || count > file.size() - offset)
+		{
+			print(Level::ERROR, "\t\t\t\tTexture Data Exceeds The File Size: " + std::to_string(offset) + " + " + std::to_string(count));
+			return nullptr;
 		}
-			
+		return file.data() + offset;
 	}
 
 	void Texture::allocateMemory()
@@ -219,101 +228,78 @@ namespace tpl
 			stream >> color;
 	}
 
-	void Texture::writeIndices(std::ostream& stream)
+	void Texture::writeIndices(ByteArray& file)
 	{
-		auto start_pos = stream.tellp();
-		stream.seekp(header.index_offset.cast());
-		print(Level::VERBOSE, "\t\t\t\t\tSeeking To Index Offset: " + std::to_string(header.index_offset));
-		
+		print(Level::VERBOSE, "\t\t\t\t\tIndex Offset: " + std::to_string(header.index_offset));
+
 		switch (header.bit_depth.cast())
 		{
 		case Bitdepth::COLOR_RLE:
 			print(Level::LOG, "\t\t\t\t\tRLE No Indices To Write.");
 			break;
 		case Bitdepth::COLOR_4BIT:
-			write4BitIndex(stream);
+			if (std::byte* out = reserve(file, header.index_offset.cast(), getIndexSize())) write4BitIndex(out);
 			break;
 		case Bitdepth::COLOR_8BIT:
-			write8BitIndex(stream);
+			if (std::byte* out = reserve(file, header.index_offset.cast(), getIndexSize())) write8BitIndex(out);
 			break;
 		}
-
-		print(Level::VERBOSE, "\t\t\t\t\tSeeking To Starting Offset: " + std::to_string(start_pos));
-		stream.seekp(start_pos);
 	}
 
-	void Texture::write4BitIndex(std::ostream& stream)
+	void Texture::write4BitIndex(std::byte* out)
 	{
-		char buffer;
-		for (size_t i = 0; i < indices.size(); i += 2)
-		{
-			buffer = indices[i + 1] * 0x10 + (indices[i]);
-			stream.write(&buffer, 1);
-		}
+		packIndices4(indices.data(), indices.size(), reinterpret_cast<unsigned char*>(out));
 	}
 
-	void Texture::write8BitIndex(std::ostream& stream)
+	void Texture::write8BitIndex(std::byte* out)
 	{
-		for (auto& index : indices)
-			stream << index;
+		std::memcpy(out, indices.data(), indices.size());
 	}
 
-	void Texture::writePalette(std::ostream& stream)
+	void Texture::writePalette(ByteArray& file)
 	{
-		auto start_pos = stream.tellp();
-		if (hasPalette())
-		{
-			print(Level::VERBOSE, "\t\t\t\t\tSeeking To Palette Offset: " + std::to_string(header.palette_offset.cast()));
-			stream.seekp(header.palette_offset.cast());
-		}
-		else
-		{
-			print(Level::VERBOSE, "\t\t\t\t\tNon-Palette Format - Seeking To Index Offset Instead: " + std::to_string(header.index_offset.cast()));
-			stream.seekp(header.index_offset.cast());
-		}
+		// Non-palette formats store their colours at the index offset instead
+		const uint32_t offset = hasPalette() ? header.palette_offset.cast() : header.index_offset.cast();
+		const uint32_t size	  = hasPalette() ? getPaletteSize() : getIndexSize();
+		print(Level::VERBOSE, "\t\t\t\t\tPalette Offset: " + std::to_string(offset));
+
+		std::byte* out = reserve(file, offset, size);
+		if (!out) return;
 
 		switch (header.bit_depth)
 		{
 		case Bitdepth::COLOR_RLE:
-			writeRLEPalette(stream);
+			writeRLEPalette(out);
 			break;
 		case Bitdepth::COLOR_4BIT:
-			write4BitPalette(stream);
+			write4BitPalette(out);
 			break;
 		case Bitdepth::COLOR_8BIT:
-			write8BitPalette(stream);
+			write8BitPalette(out);
 			break;
 		default:
 			print(Level::ERROR, "\t\t\t\t\tUnable To Load TPL Color Palette : Unknown Bitdepth[" + std::to_string(header.bit_depth.cast()) + "]");
 		}
-
-		stream.seekp(start_pos);
 	}
 
-	void Texture::writeRLEPalette(std::ostream& stream)
+	void Texture::writeRLEPalette(std::byte* out)
 	{
 		print(Level::LOG, "\t\t\t\t\tWriting RLE Palette");
-		for (auto& color : palette)
-			stream << color;
+		storeColors(palette.data(), palette.size(), out);
 	}
 
-	void Texture::write4BitPalette(std::ostream& stream)
+	// Each half of a 4-bit palette is followed by 0x20 bytes of padding, left zeroed in the buffer
+	void Texture::write4BitPalette(std::byte* out)
 	{
 		print(Level::LOG, "\t\t\t\t\tWriting 4-bit Palette");
-		for (int i = 0; i < 8; i++)
-			stream << palette[i];
-		stream.seekp((size_t)stream.tellp() + 32);
-		for (int i = 8; i < 16; i++)
-			stream << palette[i];
-		stream.seekp((size_t)stream.tellp() + 28);
-		stream << le_uint32_t(0);
+		storeColors(palette.data(),		8, out);
+		storeColors(palette.data() + 8, 8, out + 0x40);
 	}
 
-	void Texture::write8BitPalette(std::ostream& stream)
+	void Texture::write8BitPalette(std::byte* out)
 	{
 		print(Level::LOG, "\t\t\t\t\tWriting 8-bit Palette");
-		for (auto& color : palette)
-			stream << color;
+		storeColors(palette.data(), std::min<size_t>(palette.size(), 0x100), out);
 	}
 
 	bool Texture::hasPalette()
@@ -324,68 +310,193 @@ namespace tpl
 	void Texture::saveTGA(const std::string& path)
 	{
 		tga::Header newHeader{ 0, 0, 2, 0, 0, 0, 0, 0, header.width, header.height, 0x20, 0x00 };
-		
-		std::ofstream test(path, std::ios::binary);
-		if (!test.is_open()) return;
 
-		test << newHeader;
-
-		std::vector<unsigned char> pixels;
-		if (header.interlacing.cast() == InterlaceMode::PS2)
-			pixels = indices;
-		else
-			pixels = indices;
+		std::ostringstream headerStream;
+		headerStream << newHeader;
+		const std::string headerBytes = headerStream.str();
 
+		// The whole image is decoded into one buffer: header, texels and the trailing byte, then written at once.
+		// The header is placed so that it ends on a word boundary, keeping the texels aligned
+		const size_t texelCount = hasPalette() ? indices.size() : palette.size();
+		const size_t lead		= (headerBytes.size() + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+		std::vector<uint32_t> image(lead + texelCount + 1);
+		uint32_t* texels = image.data() + lead;
+		auto*	  bytes	 = reinterpret_cast<unsigned char*>(texels) - headerBytes.size();
+		std::memcpy(bytes, headerBytes.data(), headerBytes.size());
 
 		if (hasPalette())
-			for (auto index : pixels)
-				palette[index].writeNormalized(test);
+		{
+			uint32_t table[256]{};
+			normalizeColors(palette.data(), std::min<size_t>(palette.size(), 256), table);
+
+			// GS native textures are stored swizzled, with 8-bit CLUTs in CSM1 order
+			const unsigned char* source = indices.data();
+			std::vector<unsigned char> linear;
+			if (header.interlacing.cast() == InterlaceMode::PS2)
+			{
+				gs::Format format = header.bit_depth.cast() == Bitdepth::COLOR_4BIT ? gs::Format::PSMT4 : gs::Format::PSMT8;
+				linear.resize(indices.size());
+				if (gs::unswizzle(format, header.width.cast(), header.height.cast(), indices.data(), linear.data()))
+					source = linear.data();
+				else
+					print(Level::ERROR, "\t\tUnsupported Swizzled Texture Size. Writing Indices As Stored: " + path);
+
+				if (format == gs::Format::PSMT8) gs::shuffleClut(table);
+			}
+			expandIndices(source, indices.size(), table, texels);
+		}
 		else
-			for (auto color : palette)
-				color.writeNormalized(test);
-		test << le_uint8_t(1);
-	}
+			normalizeColors(palette.data(), palette.size(), texels);
+		bytes[headerBytes.size() + texelCount * sizeof(uint32_t)] = 1;
 
-	std::vector<unsigned char> Texture::unswizzle(const std::vector<unsigned char>& originalPixels)
-	{
-		static unsigned char InterlaceMatrix[] = {
-			0x00, 0x10, 0x02, 0x12,
-			0x11, 0x01, 0x13, 0x03,
-		};
+		NativeFile out(path, NativeFile::Mode::WRITE);
+		if (!out.is_open() || !out.write(0, bytes, headerBytes.size() + texelCount * sizeof(uint32_t) + 1))
+			print(Level::ERROR, "\t\tUnable To Write TGA: " + path);
+	}
 
-		static int Matrix[]        = { 0, 1, -1, 0 };
-		static int TileMatrix[]    = { 4, -4 };
+	// Feeds a mapped file to tga::Decoder. Reading past the end returns 0 and clears ok()
+	class ViewFileInterface : public tga::FileInterface {
+	public:
+		ViewFileInterface(ByteView data) : data(data) {}
 
-		std::vector<unsigned char> newPixels( size_t(header.width) * size_t(header.height), '\0' );
-		for (int y = 0; y < header.height; y++)
+		bool	ok() const override		{ return good; }
+		size_t	tell() override			{ return cursor; }
+		void	seek(size_t absPos) override	{ cursor = absPos; }
+		void	write8(uint8_t) override	{ good = false; }
+		uint8_t read8() override
 		{
-			bool oddRow = ((y & 1) != 0);
+			if (cursor >= data.size()) { good = false; return 0; }
+			return std::to_integer<uint8_t>(data[cursor++]);
+		}
+
+	private:
+		ByteView data;
+		size_t	 cursor{};
+		bool	 good{ true };
+	};
 
-			int num1   = ((y / 4) & 1);
-			int num3   = (y % 4);
+	bool Texture::loadTGA(const std::string& path, const CompileOptions& options, thread_pool& pool)
+	{
+		auto fail = [this, &path](const std::string& reason) { print(Level::ERROR, "\t\t" + reason + ": " + path); return false; };
+		MappedFile file(path);
+		if (!file.is_open()) return fail("Unable To Read TGA");
+
+		ViewFileInterface stream(file.view(0, file.size()));
+		tga::Decoder	  decoder(&stream);
+		tga::Header		  image{};
+		if (!decoder.readHeader(image) || !stream.ok()) return fail("Unsupported TGA Format");
+
+		const size_t width = image.width, height = image.height, count = width * height;
+		std::vector<unsigned char> buffer(count * image.bytesPerPixel());
+		tga::Image decoded{ buffer.data(), uint32_t(image.bytesPerPixel()), uint32_t(width * image.bytesPerPixel()) };
+		if (!decoder.readImage(image, decoded) || !stream.ok()) return fail("Truncated TGA");
+
+		// postProcessImage is skipped on purpose: it makes images whose alpha is all zero opaque, which would not survive a round trip.
+		// Channels are kept as saveTGA writes them, so the first byte of each pixel (TGA blue) is Color::r and alpha is halved back to the PS2 range
+		auto color = [](const tga::color_t& value) -> Interface::Color
+			{
+				return { tga::getb(value), tga::getg(value), tga::getr(value), uint8_t((tga::geta(value) + 1) / 2) };
+			};
 
-			for (int x = 0; x < header.width; x++)
+		// The decoder returns rows top down, while saveTGA writes texture rows in order under a bottom up descriptor
+		std::vector<Interface::Color> pixels(count);
+		for (size_t y = 0; y < height; y++)
+			for (size_t x = 0; x < width; x++)
 			{
-				int num2 = ((x / 4) & 1);
+				Interface::Color& pixel = pixels[(height - 1 - y) * width + x];
+				const size_t	  n		= y * width + x;
+				if (image.isRgb())
+				{
+					tga::color_t value;
+					std::memcpy(&value, buffer.data() + n * sizeof(value), sizeof(value));
+					pixel = color(value);
+				}
+				else if (image.isGray())
+					pixel = { buffer[n], buffer[n], buffer[n], 0x80 };
+				else
+				{
+					size_t index = size_t(buffer[n]) - image.colormapOrigin;
+					pixel = index < size_t(image.colormap.size()) ? color(image.colormap[int(index)]) : Interface::Color{};
+				}
+			}
+
+		compile(pixels, image.width, image.height, options, pool);
+		return true;
+	}
+
+	double Texture::compile(const std::vector<Interface::Color>& pixels, const uint16_t& width, const uint16_t& height, const CompileOptions& options, thread_pool& pool)
+	{
+		header = {};
+		header.width  = width;
+		header.height = height;
+		return encode(pixels, options, pool);
+	}
 
-				int num4 = ((x / 4) % 4);
-				if (oddRow) num4 += 4;
+	double Texture::requantize(const CompileOptions& options, thread_pool& pool, Texture* parent)
+	{
+		if (hasPalette()) return 0.0;
 
-				int num5 = ((x * 4) % 16);
-				int num6 = ((x / 16) * 32);
+		std::vector<Interface::Color> pixels = std::move(palette);
+		return encode(pixels, options, pool, parent);
+	}
 
-				int num7 = (oddRow) ? ((y - 1) * header.width) : (y * header.width);
+	double Texture::encode(const std::vector<Interface::Color>& pixels, const CompileOptions& options, thread_pool& pool, Texture* parent)
+	{
+		const uint16_t width = header.width.cast(), height = header.height.cast();
+		static const double UNUSABLE = std::numeric_limits<double>::infinity();
+		indices.clear();
+		header.interlacing = InterlaceMode::NONE;
+
+		if (options.depth == 32 && !parent)
+		{
+			header.bit_depth = Bitdepth::COLOR_RLE;
+			palette = pixels;
+			return 0.0;
+		}
 
-				int xx = x + num1 * TileMatrix[num2];
-				int yy = y + Matrix[num3];
+		// Mipmaps have no CLUT of their own, so they take the format, interlacing and palette of their texture
+		bool fourBit = parent ? parent->header.bit_depth.cast() == Bitdepth::COLOR_4BIT : options.depth == 4;
+		bool swizzle = parent ? parent->header.interlacing.cast() == InterlaceMode::PS2 : options.swizzle;
+		if (fourBit && (size_t(width) * height) % 2)
+		{
+			if (parent) return UNUSABLE;
+			print(Level::ERROR, "\t\t4-bit Textures Need An Even Pixel Count. Using 8-bit Instead.");
+			fourBit = false;
+		}
 
-				int i = InterlaceMatrix[num4] + num5 + num6 + num7;
-				int j = yy * header.width + xx;
+		header.bit_depth = fourBit ? Bitdepth::COLOR_4BIT : Bitdepth::COLOR_8BIT;
+		Quantization result;
+		if (parent)
+		{
+			std::vector<Interface::Color> clut = parent->palette;
+			clut.resize(0x100);
+			if (swizzle && !fourBit) gs::shuffleClut(clut.data());
+			clut.resize(fourBit ? 0x10 : 0x100);
+			result = remap(pixels.data(), width, height, clut, options.dither, pool);
+		}
+		else
+			result = quantize(pixels.data(), width, height, fourBit ? 0x10 : 0x100, options.dither, pool);
+		indices = std::move(result.indices);
+		palette = std::move(result.palette);
+		palette.resize(0x100);
 
-				newPixels[j] = originalPixels[i];
+		if (swizzle)
+		{
+			gs::Format format = fourBit ? gs::Format::PSMT4 : gs::Format::PSMT8;
+			std::vector<unsigned char> swizzled(indices.size());
+			if (gs::swizzle(format, width, height, indices.data(), swizzled.data()))
+			{
+				indices.swap(swizzled);
+				header.interlacing = InterlaceMode::PS2;
+				if (format == gs::Format::PSMT8) gs::shuffleClut(palette.data());
 			}
+			else if (parent)
+				return UNUSABLE;
+			else
+				print(Level::ERROR, "\t\tUnsupported Swizzled Texture Size. Stored Linear Instead.");
 		}
 
-		return newPixels;
+		if (parent) palette = parent->palette;
+		return result.error;
 	}
 }
\ No newline at end of file
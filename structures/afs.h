@@ -1,6 +1,8 @@
 #pragma once
 
 #include "include/sys_io.h"
+#include "include/sys_file.h"
+#include "include/hash.h"
 #include "interface/common.h"
 #include "afsinfo.h"
 
@@ -8,6 +10,9 @@
 #include <fstream>
 #include <vector>
 #include <filesystem>
+#include <set>
+#include <unordered_map>
+#include <deque>
 
 using namespace Interface;
 
@@ -19,6 +24,9 @@ namespace afs
 		{
 			le_uint32_t offset{}, size{};
 			ByteArray rawData{};
+			ByteView  view{};								// Points into the mapping when opened with mapFromFile
+
+			ByteView data() const { return rawData.empty() ? view : ByteView(rawData); }
 		};
 
 		struct FileTable
@@ -48,14 +56,21 @@ namespace afs
 		static inline const uint16_t    ENTRY_SIZE		{ 0x30 };
 		static inline const std::string SIGNATURE		{ "AFS" };
 		static inline const std::string SIZE0			{ "size0.dat" + std::string(0x27, '\0')};
+		static inline const uint64_t	MAX_IN_FLIGHT	{ 0x4000000 };				// Bytes read ahead of the writer during a build
 
 		std::string signature{ "AFS\0" };
 		le_uint32_t file_count{};
 		std::vector<Entry> files{};
 
 		dat::AfsInfo datInfo;
+		MappedFile	 mapping;
+		std::unordered_map<std::string, size_t> name_index;	// File table names and afsinfo paths, built once on load
+		std::vector<size_t> duplicate_of{};					// Entry whose payload each entry shares. Its own index when unique
+		NativeFile	 archive;								// Source handle for kernel side copies out of a mapped archive
 
-		size_t indexFromName(const std::string& name);
+		void buildNameIndex();
+		std::string entryPath(const size_t& index, const std::string& path);
+		bool writeEntry(const size_t& index, const std::string& outpath);
 
 		bool validateHeader(std::istream& stream);
 		void getFileCount(std::istream& stream);
@@ -64,6 +79,7 @@ namespace afs
 		void readFileTableHeader(std::istream& stream);
 		void allocateFileMemory();
 		void readEntries(std::istream& stream);
+		void mapEntries();
 		void readFileTable(std::istream& stream);
 
 		void readDatInfo();
@@ -71,29 +87,66 @@ namespace afs
 		void buildAfsInfo(const std::string path);
 
 		void buildFileTable();
-		void calculateOffsets();
+		void calculateOffsets(const std::vector<size_t>& trace = {});
+		std::vector<size_t> physicalOrder(const std::vector<size_t>& trace);
+		std::vector<size_t> loadTrace(const std::string& path);
+		std::pair<size_t, uint64_t> traceCost(const std::vector<size_t>& trace);
 		void writeFile(const std::string& path);
 		void writeHeader(std::ostream& stream);
-		void readFilesToEntries(const std::string& path);
+		void readFileSizes();
+		uint64_t findDuplicates(const std::string& source);
+		bool sameContents(const std::string& lhs, const std::string& rhs, const uint32_t& size);
+		ByteArray readSource(const std::string& source, const size_t& index);
+		void streamEntries(const std::string& source, const std::string& path);
 		void writeEntryHeaders(std::ostream& stream);
 		void writeEntries(std::ostream& stream);
 		void writeFileTable(std::ostream& stream);
 		void padRemainingFile(std::ostream& stream);
 		void generateAfsInfo();
+
+		void unmap();
+		uint32_t slotCapacity(const size_t& index);
+		bool writeZeros(const NativeFile& stream, uint64_t offset, uint64_t count);
+		bool writeRecords(const NativeFile& stream, const size_t& index);
 	public:
 		AfsFile(const Interface::Log& log) : Logger(&log), datInfo(log) {};
 		AfsFile(const std::string& path, const Interface::Log& log);
 
 		bool loadFromFile(const std::string& path);
+		bool mapFromFile(const std::string& path);
+
+		size_t		size();
+		ByteView	getData(const size_t& index);
+		uint32_t	entryOffset(const size_t& index);
+		std::string entryName(const size_t& index);
+
+		/* hashEntries
+		*  Queues an xxh64 of every entry onto the pool, reading straight from the mapping. Results are only valid once the caller has waited on the pool.
+		*/
+		void hashEntries(thread_pool& pool, std::vector<uint64_t>& hashes);
 
 		void extract(const size_t& index, const std::string& path, const bool& ignore_empty);
 		void extract(const std::string& name, const std::string& path, const bool& ignore_empty);
+		void extract(std::vector<size_t> indices, const std::string& path, const bool& ignore_empty);
 		void extractAll(const std::string& path, const bool& ignore_empty = false);
 
-		void buildAfs(const std::string& path, const std::string& out);
+		/* extractedRange
+		*  The indices extractAll writes for an archive of `count` entries, as [first, last). The first entry (afsinfo) and the last are left out.
+		*/
+		static std::pair<size_t, size_t> extractedRange(const size_t& count);
+
+		size_t indexFromName(const std::string& name);
+		std::vector<size_t> resolveNames(const std::vector<std::string>& patterns);
+
+		/* buildAfs
+		*  Builds an AFS from the contents of a directory. When a trace file is given (entry indices or names in load order)
+		*  payloads are laid out in the order they are first loaded. TOC order is unchanged, so the game indexes them the same.
+		*/
+		void buildAfs(const std::string& path, const std::string& out, const bool& deduplicate = false, const std::string& trace = "");
 		void save(const std::string& path);
+		bool patch(const std::string& path, const std::vector<std::pair<size_t, std::string>>& replacements);
 
 		std::vector<std::string> getFileNames();
-		std::vector<std::string> getFilePaths();
+		std::vector<std::string_view> getFilePaths();
 	};
 }
@@ -1,10 +1,13 @@
 #pragma once
 
 #include "include/sys_io.h"
+#include "include/sys_file.h"
 #include "interface/common.h"
 
 #include <vector>
 #include <string>
+#include <string_view>
+#include <cstring>
 #include <filesystem>
 
 using namespace Interface;
@@ -15,36 +18,38 @@ namespace dat
 	{
 		struct Entry
 		{
-			std::string filename{};
-			le_uint32_t size{};
+			std::string_view filename{};				// Points into arena
+			le_uint32_t		 size{};
 		};
 
 		std::vector<Entry> entries;
-
-		std::string readString(std::istream& stream);
+		std::vector<char>  arena;						// Backing storage for every filename. Never resized once views are handed out
 
 		void clearMemory();
 		void allocateMemory(const size_t& count);
 
-		void readEntries(std::istream& stream);
-		void readStrings(std::istream& stream);
-		void readSizes(std::istream& stream);
+		size_t readStrings(ByteView data);
+		void   readSizes(ByteView data, size_t cursor);
 
 	public:
 		AfsInfo(const Interface::Log& log) : Logger(&log) {};
-		void load(const ByteArray& data, const size_t& count);
+		AfsInfo(const AfsInfo&)			   = delete;	// Copies would leave the views pointing at the source's arena
+		AfsInfo& operator=(const AfsInfo&) = delete;
+
+		void load(ByteView data, const size_t& count);
 
 		size_t size();
 		Entry& operator[] (const size_t& index);
 
-		std::vector<std::string> getFilePaths();
+		std::vector<std::string_view> getFilePaths();
 		const std::vector<Entry>& getEntries();
 
 		void build(const std::string& path);
 		size_t calculateSize();
+		size_t sizeOffset(const size_t& index);
 
 		ByteArray compile();
-		void writeStrings(std::ostream& stream);
-		void writeSizes(std::ostream& stream);
+		std::byte* writeStrings(std::byte* cursor);
+		std::byte* writeSizes(std::byte* cursor);
 	};
 }
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "include/sys_file.h"
+#include "include/hash.h"
+#include "interface/common.h"
+#include "afs.h"
+
+#include <vector>
+#include <string>
+#include <fstream>
+
+using namespace Interface;
+
+namespace afs
+{
+	/* AfsManifest
+	*  Offset, size and xxh64 of every entry in an AFS archive. Stored as text so it can be diffed and kept under version control.
+	*  Verifies either the archive it came from, or a directory that archive was extracted into. Hashing runs on every core.
+	*/
+	class AfsManifest : protected Interface::Logger
+	{
+		struct Entry
+		{
+			uint32_t	offset{}, size{};
+			uint64_t	hash{};
+			std::string name{};
+		};
+
+		static inline const std::string HEADER{ "# afs-manifest xxh64" };
+
+		std::vector<Entry> entries{};
+
+		bool parseLine(const std::string& line);
+
+	public:
+		struct Failure
+		{
+			size_t		index{};
+			std::string reason{};
+		};
+
+		AfsManifest(const Interface::Log& log) : Logger(&log) {}
+
+		void build(AfsFile& file);
+		bool save(const std::string& path);
+		bool load(const std::string& path);
+
+		size_t		 size()							const { return entries.size(); }
+		const Entry& operator[](const size_t& index) const { return entries[index]; }
+
+		/* verify
+		*  Returns every entry that does not match the manifest. Archives are checked by offset, size and hash;
+		*  directories by size and hash of each file extractAll writes, so afsinfo and the last entry are skipped there.
+		*  Files that were never extracted are reported as missing.
+		*/
+		std::vector<Failure> verify(AfsFile& file);
+		std::vector<Failure> verify(const std::string& directory);
+	};
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "include/sys_io.h"
+#include "include/sys_file.h"
+#include "interface/common.h"
+
+#include <array>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <string_view>
+
+using namespace Interface;
+
+namespace afs
+{
+	/* AfsToc
+	*  Read only table of contents for an AFS archive. Only the header, TOC and file table are read; entry payloads are never touched.
+	*  Records are stored as parallel arrays so listing thousands of entries costs three allocations rather than one per entry.
+	*/
+	class AfsToc : protected Interface::Logger
+	{
+		static inline const uint8_t  FILENAME_LENGTH{ 0x20 };
+		static inline const uint8_t  ENTRY_SIZE		{ 0x30 };
+		static inline const uint32_t HEADER_SIZE	{ 0x08 };
+
+		std::vector<uint32_t>							   offsets{};
+		std::vector<uint32_t>							   sizes{};
+		std::vector<std::array<char, FILENAME_LENGTH>>	   names{};
+
+		uint64_t filesize{};
+
+		bool readEntryHeaders(const NativeFile& file, const uint32_t& count);
+		void readFileTable(const NativeFile& file, const uint32_t& offset);
+
+	public:
+		AfsToc(const Interface::Log& log) : Logger(&log) {}
+
+		bool load(const std::string& path);
+
+		size_t			 size()							   const { return offsets.size(); }
+		uint32_t		 offset(const size_t& index)	   const { return offsets[index]; }
+		uint32_t		 entrySize(const size_t& index)	   const { return sizes[index]; }
+		std::string_view name(const size_t& index)		   const;
+	};
+}
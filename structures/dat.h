@@ -6,9 +6,11 @@
 #include <string>
 #include <fstream>
 #include <string_view>
+#include <cstring>
 #include <filesystem>
 
 #include "include/sys_io.h"
+#include "include/sys_file.h"
 #include "interface/common.h"
 
 using namespace Interface;
@@ -16,12 +18,38 @@ using namespace Interface;
 
 namespace dat
 {
+	/* SegmentFilter
+	*  Selects segments by 4CC and index range, using only what is in the header. An empty include list or range list selects everything.
+	*  Dummy segments match the type "DMY". Types are compared case insensitively.
+	*/
+	struct SegmentFilter
+	{
+		std::vector<std::string>			  include{};
+		std::vector<std::string>			  exclude{};
+		std::vector<std::pair<size_t, size_t>> ranges{};				// Inclusive
+
+		bool accepts(const size_t& index, const std::string& format) const
+		{
+			std::string type = StringToLower(format.empty() ? "DMY" : format);
+			auto matches = [&type](const std::vector<std::string>& types)
+				{ return std::any_of(types.begin(), types.end(), [&type](const std::string& t) { return StringToLower(t) == type; }); };
+
+			if (!include.empty() && !matches(include)) return false;
+			if (matches(exclude)) return false;
+			if (ranges.empty()) return true;
+			return std::any_of(ranges.begin(), ranges.end(), [&index](const auto& range) { return index >= range.first && index <= range.second; });
+		}
+	};
+
 	template<std::endian endianness = std::endian::little>
 	struct Entry
 	{
 		std::string segmentType = "    ";
 		Scalar<uint32_t, endianness> offset{};
 		ByteArray data{};
+		uint32_t  size{};									// Size of the segment in the source
+		bool	  loaded{ true };							// False until data has been fetched from the source
+		std::string path{};									// Input file streamed in on save. Empty when the segment is in memory or the source
 	};
 
 	template<std::endian endianness = std::endian::little>
@@ -34,12 +62,14 @@ namespace dat
 		std::vector<Entry<endianness>> entries;
 
 		size_t		  filesize{};
+		MappedFile	  mapping{};								// Owned source when loaded from a file
+		ByteView	  source{};									// Where unloaded segments are fetched from. The mapping, or a caller's buffer
 
 		/* Parse
 		*  Pipeline for loading the raw data from stream.
 		*  Returns if file parsing was successful. On failure, it is assumed the file may have swapped endianness.
 		*/
-		bool parse(std::ifstream& stream)
+		bool parse(std::istream& stream)
 		{
 			print(Level::LOG, "\tInitializing File: ");
 			auto entryCount = getFileCount(stream);
@@ -54,10 +84,8 @@ namespace dat
 			entries.resize(entryCount);					// Resize entries using entryCount
 			print(Level::LOG, "\tReading Header: ");
 			readHeader(stream);
-			print(Level::LOG, "\tAllocating memory...");
-			allocateMemory(entryCount);
-			print(Level::LOG, "\tLoading Entries...");
-			loadAll(stream);
+			print(Level::LOG, "\tCalculating Segment Sizes...");
+			calculateSizes();
 			return true;
 		}
 
@@ -65,7 +93,7 @@ namespace dat
 		*  Reads the file count from the stream. Then progresses the stream to the position needed for the next step.
 		*  Returns how many child files are contained within the dat.
 		*/
-		uint32_t getFileCount(std::ifstream& stream)
+		uint32_t getFileCount(std::istream& stream)
 		{
 			Scalar<uint32_t, endianness> count;
 			stream >> count;
@@ -76,7 +104,7 @@ namespace dat
 		/* readHeader
 		*  Load the header offsets, and segment formatting from stream. 
 		*/
-		void readHeader(std::ifstream& stream)
+		void readHeader(std::istream& stream)
 		{
 			print(Level::LOG, "\t\tLoading Segment Offsets...");
 			for (auto& entry : entries)
@@ -96,12 +124,12 @@ namespace dat
 			}
 		}
 
-		/* allocateMemory
-		*  Resize ByteArrays to be the appropriate size to hold the data contained in each segment
+		/* calculateSizes
+		*  Record how large each segment is. Nothing is read or allocated; segments are fetched on first access.
 		*  Size is calculated by substracting the starting offset of the next segment, from the starting offset of the current.
 		*  The last chunk is calculated by the difference of the file size to the last chunk.
 		*/
-		void allocateMemory(const uint32_t& entryCount)
+		void calculateSizes()
 		{
 			for (size_t i = 0; i < entries.size() - 1; i++)
 			{
@@ -109,33 +137,54 @@ namespace dat
 				if (static_cast<uint32_t>(entries[i].offset) + size > filesize)
 					print(Level::EXCEPTION, EXCEPT_TEXT("offset: " + to_hex(size.cast<std::endian::little>()) + " Exceeds Bounds Of File."));
 				print(Level::VERBOSE, "\t\t" + to_hex(size.cast<std::endian::little>()) + "b");
-				entries[i].data.resize(size);
+				entries[i].size	  = size;
+				entries[i].loaded = false;
 			}
-			entries[entries.size() - 1].data.resize(filesize - entries[entries.size() - 1].offset);
+			entries[entries.size() - 1].size   = static_cast<uint32_t>(filesize - entries[entries.size() - 1].offset);
+			entries[entries.size() - 1].loaded = false;
 			print(Level::VERBOSE, "\t\t" + to_hex( be_uint32_t( static_cast<uint32_t>( filesize - entries[entries.size() - 1].offset) ) ) + "b");
 		}
 
 		/* loadAll
-		*  load() each chunk into memory.
+		*  load() every segment still in the source. Needed before the entries are rewritten. Segments backed by an input file
+		*  are left alone; save streams those straight into the output.
 		*/
-		void loadAll(std::ifstream& stream)
+		void loadAll()
 		{
-			print(Level::LOG, "\tLoading All Segments...");
 			for (size_t i = 0; i < entries.size(); i++)
-				load(i, stream);
+				if (entries[i].path.empty()) load(i);
+		}
+
+		/* segmentSize
+		*  Size a segment will occupy in a compiled file, whether or not it has been loaded.
+		*/
+		uint32_t segmentSize(const Entry<endianness>& entry) const
+		{
+			return entry.loaded ? static_cast<uint32_t>(entry.data.size()) : entry.size;
 		}
 
 		/* load
-		*  Retrieve the data for the chunk from stream.
+		*  Copy a segment out of the source the first time it is needed.
 		*/
-		void load(const size_t& index, std::ifstream& stream)
+		void load(const size_t& index)
 		{
-			print(Level::VERBOSE, "\t\tLoading Chunk " + std::to_string(index) + " From Stream...");
-			if (index > entries.size())
+			if (index >= entries.size())
 				print(Level::EXCEPTION, EXCEPT_TEXT("Unable To Load Entry. Exceeds Bounds Of Array!"));
 
-			stream.seekg(entries[index].offset.cast());
-			stream.read((char*)entries[index].data.data(), entries[index].data.size());
+			Entry<endianness>& entry = entries[index];
+			if (entry.loaded) return;
+
+			if (!entry.path.empty())
+			{
+				entry.data = Interface::getFileData(entry.path);
+				entry.data.resize(entry.size);
+				entry.loaded = true;
+				return;
+			}
+
+			ByteView data = segment(index);
+			entry.data.assign(data.begin(), data.end());
+			entry.loaded = true;
 		}
 
 		/* extension
@@ -164,7 +213,7 @@ namespace dat
 			{
 				startingOffset = (startingOffset / 0x20 + (startingOffset % 0x20 != 0)) * 0x20;
 				entry.offset = startingOffset;
-				startingOffset += static_cast<uint32_t>(entry.data.size());
+				startingOffset += segmentSize(entry);
 			}
 		}
 
@@ -188,15 +237,40 @@ namespace dat
 		}
 
 		/* writeData
-		*  Write each chunk sequentially after writing the header.
+		*  Write each chunk sequentially after writing the header. Segments backed by an input file are streamed in,
+		*  so no more than one stream buffer of any input is held in memory.
 		*/
 		void writeData(std::ofstream& stream)
 		{
+			static const char padding[0x20]{};
+
 			for (auto& entry : entries)
 			{
 				stream.seekp(entry.offset.cast());
-				stream.write((const char*)entry.data.data(), entry.data.size());
+				if (entry.loaded)
+					stream.write((const char*)entry.data.data(), entry.data.size());
+				else
+					streamFile(entry, stream);
 			}
+
+			if (entries.empty()) return;
+			uint64_t end = entries.back().offset.cast() + segmentSize(entries.back());		// Streamed files still end on a 0x20 boundary
+			uint64_t position = static_cast<uint64_t>(stream.tellp());
+			if (position < end) stream.write(padding, end - position);
+		}
+
+		/* streamFile
+		*  Copy an input file into the output at the current position.
+		*/
+		void streamFile(const Entry<endianness>& entry, std::ofstream& stream)
+		{
+			std::ifstream in(entry.path, std::ios::binary);
+			if (!in.is_open())
+			{
+				print(Level::ERROR, "\tUnable To Open Input File: " + entry.path);
+				return;
+			}
+			if (std::filesystem::file_size(entry.path)) stream << in.rdbuf();		// Inserting an empty buffer would set failbit
 		}
 
 	public:
@@ -211,32 +285,59 @@ namespace dat
 		}
 
 		/* loadFromFile
-		*  Create a file stream and parse the contents of the file.
+		*  Map the file and parse its header. Only the header is read here; segments are fetched from the mapping when first accessed.
 		*  returns success status. On failure it is safe to assume the file may have swapped endianness than expectation.
 		*/
 		bool loadFromFile(const std::string& path)
 		{
-			print(Level::VERBOSE, "\tCreating File Stream.");
-			std::ifstream file(path, std::ios::ate | std::ios::binary);
-			if (!file.is_open())
+			print(Level::VERBOSE, "\tMapping File.");
+			if (!mapping.open(path))
 				print(Level::EXCEPTION, EXCEPT_TEXT("Unable To Open Requested File: " + path));
-			filesize = file.tellg();
-			file.seekg(0);
+			source	 = mapping.view(0, mapping.size());
+			filesize = source.size();
 
 			print(Level::VERBOSE, "\tFile Size: " + std::to_string(filesize));
 			entries.clear();
 
-			bool ret = parse(file);
-			file.close();
-			return ret;
+			imemstream stream(source.data(), source.size());
+			return parse(stream);
+		}
+
+		/* probe
+		*  Checks if a header is plausible for this endianness without parsing anything. The entry count must be within MAXIMUM_ENTRY_COUNT,
+		*  and the offsets must start after the header, ascend, and stay within the file. Used to pick an endianness before loading.
+		*/
+		static bool probe(ByteView header, const size_t& filesize)
+		{
+			if (header.size() < DATA_START_OFFSET) return false;
+
+			Scalar<uint32_t, endianness> count;
+			std::memcpy(&count.data(), header.data(), count.size());
+			uint32_t entryCount = count;
+			if (entryCount == 0 || entryCount > MAXIMUM_ENTRY_COUNT) return false;
+
+			size_t previous = DATA_START_OFFSET + size_t(HEADER_ENTRY_SIZE) * entryCount;
+			if (previous > filesize || previous > header.size()) return false;
+
+			Scalar<uint32_t, endianness> offset;
+			for (uint32_t i = 0; i < entryCount; i++)
+			{
+				std::memcpy(&offset.data(), header.data() + DATA_START_OFFSET + i * offset.size(), offset.size());
+				if (offset.cast() < previous || offset.cast() > filesize) return false;
+				previous = offset.cast();
+			}
+			return true;
 		}
 
 		/* loadFromMemory
 		*  Similar to loadFromFile; however, this creates a memory stream and reads from a preallocated chunk of rawdata.
+		*  Segments are fetched from data on first access, so it must outlive this DatFile or every segment must be accessed first.
 		*/
-		bool loadFromMemory(const ByteArray& data)
+		bool loadFromMemory(ByteView data)
 		{
 			print(Level::VERBOSE, "\tCreating Memory Stream.\n");
+			mapping.close();
+			source = data;
 			imemstream stream(data.data(), data.size());
 			filesize = data.size();
 
@@ -247,13 +348,36 @@ namespace dat
 		}
 
 		/* operator[]
-		*  Returns the rawdata of an entry
+		*  Returns the rawdata of an entry. The segment is read from the source on first access.
 		*/
 		const ByteArray& operator[] (const size_t index)
 		{
+			load(index);
 			return entries[index].data;
 		}
 
+		/* segment
+		*  Returns a view of an entry without copying it. Unloaded segments point straight into the source.
+		*/
+		ByteView segment(const size_t& index) const
+		{
+			const Entry<endianness>& entry = entries[index];
+			if (entry.loaded) return entry.data;
+
+			Scalar<uint32_t, endianness> offset = entry.offset;			// cast() is not const
+			if (size_t(offset.cast()) + entry.size > source.size()) return {};
+			return source.subspan(offset.cast(), entry.size);
+		}
+
+		/* format
+		*  Returns the 4CC of an entry without its null padding. Empty for dummy entries.
+		*/
+		std::string format(const size_t& index) const
+		{
+			const std::string& type = entries[index].segmentType;
+			return type.substr(0, type.find('\0'));
+		}
+
 		/* size
 		*  Returns how many entries are contained within the dat file
 		*/
@@ -268,25 +392,36 @@ namespace dat
 		*/
 		void extract(const size_t& index, const std::string& path)
 		{
-			const ByteArray& data = this->operator[](index);
+			ByteView data = segment(index);							// Written straight from the source. Nothing is copied
 
 			std::string filename = std::to_string(index) + "." + extension(index);
 
-			std::ofstream out(path + filename, std::ios::binary);
-			out.write((const char*)data.data(), data.size());
-			out.close();
+			NativeFile out(path + filename, NativeFile::Mode::WRITE);
+			if (!out.is_open() || !out.write(0, data.data(), data.size()))
+				print(Level::ERROR, "\tUnable To Write Segment: " + path + filename);
 		}
 
 		/* extractAll
-		*  for each segment extract() to specified location
+		*  for each segment accepted by the filter extract() to specified location. Segments are spread across the pool, which may be shared
+		*  with a recursive run. Rejected segments are never read, and nothing is created when no segment is accepted.
 		*/
-		void extractAll(const std::string& path)
+		void extractAll(const std::string& path, thread_pool& pool, const SegmentFilter& filter = {})
 		{
+			std::vector<size_t> selected;
+			for (size_t i = 0; i < entries.size(); i++)
+				if (filter.accepts(i, format(i))) selected.push_back(i);
+			if (selected.empty()) return;
+
 			if (!std::filesystem::exists(path))
 				std::filesystem::create_directory(path);
 
-			for (size_t i = 0; i < entries.size(); i++)
-				extract(i, path + "\\");
+			ParallelFor(pool, selected.size(), [this, &path, &selected](const size_t& i) { extract(selected[i], path + "\\"); });
+		}
+
+		void extractAll(const std::string& path, const SegmentFilter& filter = {})
+		{
+			thread_pool pool;
+			extractAll(path, pool, filter);
 		}
 
 		/* append
@@ -301,6 +436,7 @@ namespace dat
 
 		/* addDir
 		*  For each file on hard disk cycle through and append them to our dat file.
+		*  Only the path, format and size are recorded. Contents are streamed in when the file is saved.
 		*  TODO add sanity check for valid file extensions
 		*/
 		void addDir(const std::string& path)
@@ -311,24 +447,27 @@ namespace dat
 				print(Level::ERROR, "\tCould Not Find Directory: " + path);
 				return;
 			}
-			for (const auto& entry : getSequentialNumericFilenames(path))
+			auto files = scanNumericDirectory(path);
+			entries.reserve(entries.size() + files.size());
+			for (auto& file : files)
 			{
-				print(Level::LOG, "\t" + entry);
+				print(Level::LOG, "\t" + file.path);
 
-				ByteArray rawData = Interface::getFileData(entry);
+				uint32_t size = Interface::allign(static_cast<uint32_t>(file.size), 0x20);
 
-				if (std::filesystem::path(entry).extension().string() == ".DMY")
-					append(rawData, "\0\0\0\0");
+				if (file.extension == ".DMY" || file.extension.size() < 2)
+					entries.push_back({ std::string(4, '\0'), 0, {}, size, false, std::move(file.path) });
 				else
-					append(rawData, std::filesystem::path(entry).extension().string().substr(1, 3) + '\0');
+					entries.push_back({ file.extension.substr(1, 3) + '\0', 0, {}, size, false, std::move(file.path) });
 			}
 		}
 
 		/* save
-		*  Calculates new offsets, and then formats and writes the raw data to disk.
+		*  Calculates new offsets, and then formats and writes the raw data to disk. Returns false if the file could not be written.
 		*/
-		void save(const std::string& path)
+		bool save(const std::string& path)
 		{
+			loadAll();												// Fetch before the output is opened, in case it is the source
 			print(Level::VERBOSE, "\tCreating File Stream.");
 			std::ofstream out(path, std::ios::binary);
 
@@ -343,6 +482,7 @@ namespace dat
 
 			print(Level::VERBOSE, "\tClose File Stream.");
 			out.close();
+			return !out.fail();
 		}
 	};
 }
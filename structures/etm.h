@@ -1,6 +1,7 @@
 #pragma once
 
 #include "include/sys_io.h"
+#include "include/sys_file.h"
 #include "interface/common.h"
 
 #include <vector>
@@ -53,6 +54,7 @@ namespace etm
 		EtmFile(const std::string& path, const Interface::Log& log);
 
 		void loadFromFile(const std::string& path);
+		void loadFromMemory(ByteView data);
 		void saveToFile(const std::string& path);
 		void addDir(const std::string& path);
 		void extractAll(const std::string& path);
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+namespace gs
+{
+	/* Format
+	*  Indexed pixel storage modes of the GS. Swizzled data is the texture as it is uploaded into GS memory, ie read back as PSMCT32.
+	*/
+	enum class Format
+	{
+		PSMT8,
+		PSMT4
+	};
+
+	using SwizzleTable = std::vector<uint32_t>;
+
+	/* swizzleTable
+	*  Entry i is where linear pixel i sits in the swizzled data, counted in pixels (one byte or one nibble). Built from the page, block
+	*  and column layouts of GS memory, once per format and size, and cached. Null when no PSMCT32 upload rectangle holds exactly its blocks.
+	*  (Defined in src/structures/tpl/gsmemory.cpp)
+	*/
+	std::shared_ptr<const SwizzleTable> swizzleTable(const Format& format, const uint32_t& width, const uint32_t& height);
+
+	/* unswizzle / swizzle
+	*  Reorder one byte per pixel between GS and linear order through the cached table. Returns false if the size is unsupported.
+	*/
+	bool unswizzle(const Format& format, const uint32_t& width, const uint32_t& height, const unsigned char* in, unsigned char* out);
+	bool swizzle  (const Format& format, const uint32_t& width, const uint32_t& height, const unsigned char* in, unsigned char* out);
+
+	/* shuffleClut
+	*  Converts a 256 entry CLUT between linear and CSM1 order by swapping bits 3 and 4 of every index. The reordering is its own inverse.
+	*/
+	template<class color_t>
+	void shuffleClut(color_t* clut, const size_t& count = 0x100)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			size_t j = (i & ~size_t(0x18)) | ((i & 0x08) << 1) | ((i & 0x10) >> 1);
+			if (i < j && j < count) std::swap(clut[i], clut[j]);
+		}
+	}
+}
@@ -6,6 +6,7 @@
 #include <filesystem>
 
 #include "include/sys_io.h"
+#include "include/sys_file.h"
 #include "tpl.h"
 #include "bin.h"
 
@@ -38,6 +39,8 @@ namespace itm
 		ItmFile(const std::string& path, const Interface::Log& log);
 
 		void loadFromFile(const std::string& path);
+		void loadFromMemory(ByteView data);
+		void loadFromStream(std::istream& stream);
 		void getFileSize(std::istream& stream);
 
 		uint32_t getFileCount(std::istream& stream);
@@ -59,5 +62,6 @@ namespace itm
 
 		void extractTpls(const std::string& path);
 		void extractBins(const std::string& path);
+		void decompileTpls(const std::string& path);
 	};
 }
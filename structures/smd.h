@@ -76,7 +76,7 @@ namespace smd
 			return loadFromStream(stream);
 		}
 
-		bool loadFromMemory(const ByteArray& data)
+		bool loadFromMemory(ByteView data)
 		{
 			print(Level::VERBOSE, "\tCreating Memory Stream.\n");
 			imemstream stream(data.data(), data.size());
@@ -242,6 +242,11 @@ namespace smd
 				std::filesystem::create_directory(path);
 			Tpl.extractAll(path + "/");
 		}
+
+		void decompileTpl(const std::string& path)
+		{
+			Tpl.decompileAll(path + "/");
+		}
 	};
 
 
@@ -1,9 +1,11 @@
 #pragma once
 
 #include "include/sys_io.h"
+#include "include/sys_file.h"
 #include "interface/common.h"
 #include "interface/log.h"
 #include "tga.h"
+#include "gsmemory.h"
 
 #include <vector>
 #include <fstream>
@@ -21,6 +23,52 @@ namespace tpl
 	static const uint16_t COLOR_PALETTE_SIZE_8BIT {0x400};
 	static inline le_uint32_t ZERO{ 0x0 };
 
+	/* normalizeColors / expandIndices
+	*  Decode kernels for saveTGA. Texels keep the byte order of Color with alpha doubled and clamped, as writeNormalized would write them.
+	*  SSE2 is used on x86, and AVX2 is picked at runtime when the CPU supports it. (Defined in src/structures/tpl/tpl_decode.cpp)
+	*/
+	void normalizeColors(const Interface::Color* colors, const size_t& count, uint32_t* out);
+	void expandIndices(const unsigned char* indices, const size_t& count, const uint32_t* table, uint32_t* out);	// table must hold 256 texels
+
+	/* packIndices4 / storeColors
+	*  Encode kernels for serialize. Pairs of indices are packed low nibble first, and colours are stored in file order (BGRA), SSE2 on x86.
+	*  (Defined in src/structures/tpl/tpl_decode.cpp)
+	*/
+	void packIndices4(const unsigned char* indices, const size_t& count, unsigned char* out);
+	void storeColors(const Interface::Color* colors, const size_t& count, std::byte* out);
+
+	/* Quantization
+	*  RGBA pixels reduced to a palette. error is the mean squared RGBA distance per pixel, with alpha doubled to the colour range.
+	*/
+	struct Quantization
+	{
+		std::vector<Interface::Color> palette{};
+		std::vector<unsigned char>	  indices{};
+		double						  error{};
+	};
+
+	/* quantize
+	*  Builds a palette of at most `colors` entries with median cut over a colour histogram, refined by k-means, and maps every pixel to it.
+	*  Pixels that already fit are kept exactly. Matching runs across the pool. Dithering diffuses error Floyd-Steinberg style, in order.
+	*  (Defined in src/structures/tpl/tpl_quantize.cpp)
+	*/
+	Quantization quantize(const Interface::Color* pixels, const uint32_t& width, const uint32_t& height, const size_t& colors, const bool& dither, thread_pool& pool);
+
+	/* remap
+	*  Maps pixels onto an existing palette, as quantize does once its palette is built. Used for mipmaps, which share their texture's CLUT.
+	*/
+	Quantization remap(const Interface::Color* pixels, const uint32_t& width, const uint32_t& height, const std::vector<Interface::Color>& palette, const bool& dither, thread_pool& pool);
+
+	/* CompileOptions
+	*  How RGBA images are turned into textures. depth is 4 or 8 for indexed textures, or 32 to store colours directly.
+	*/
+	struct CompileOptions
+	{
+		uint16_t depth{ 8 };
+		bool	 dither{};
+		bool	 swizzle{};										// Store PS2 interlaced: indices swizzled for the GS, 8-bit CLUTs in CSM1 order
+	};
+
 	class Texture : protected Interface::Logger					// Defined in src/structures/tpl/tpl_entry.cpp
 	{
 		struct InterlaceMode
@@ -73,28 +121,30 @@ namespace tpl
 		void load4BitIndex(std::istream& stream);
 		void load8BitIndex(std::istream& stream);
 
-		void writeIndices(std::ostream& stream);
-		void write4BitIndex(std::ostream& stream);
-		void write8BitIndex(std::ostream& stream);
+		std::byte* reserve(ByteArray& file, const size_t& offset, const size_t& count);		// Null (and logged) if the block does not fit
+
+		void writeIndices(ByteArray& file);
+		void write4BitIndex(std::byte* out);
+		void write8BitIndex(std::byte* out);
 
 		void loadPalette(std::istream& stream);
 		void loadRLEPalette(std::istream& stream);
 		void load4BitPalete(std::istream& stream);
 		void load8itPalete(std::istream& stream);
 
-		void writePalette(std::ostream& stream);
-		void writeRLEPalette(std::ostream& stream);
-		void write4BitPalette(std::ostream& stream);
-		void write8BitPalette(std::ostream& stream);
+		void writePalette(ByteArray& file);
+		void writeRLEPalette(std::byte* out);
+		void write4BitPalette(std::byte* out);
+		void write8BitPalette(std::byte* out);
 
-		std::vector<unsigned char> unswizzle(const std::vector<unsigned char>&);
+		double encode(const std::vector<Interface::Color>& pixels, const CompileOptions& options, thread_pool& pool, Texture* parent = nullptr);
 
 	public:
 		Texture(const Interface::Log& log) : Logger(&log) {}
 		void load(std::istream& stream, const uint32_t& palette_offset = 0);
 
-		void writeHeader(std::ostream& stream, bool mipmap = false);
-		void writeData(std::ostream& stream, bool mipmap = false);
+		void writeHeader(ByteArray& file, const size_t& offset, bool mipmap = false);		// Write into a whole file buffer sized by calculateOffsets
+		void writeData(ByteArray& file, bool mipmap = false);
 
 		bool hasMipmaps() ;
 		uint16_t getMipmapCount();
@@ -110,7 +160,25 @@ namespace tpl
 
 		bool hasPalette();
 		void saveTGA(const std::string& path);
-		//void loadTGA(const std::string& path);
+		bool loadTGA(const std::string& path, const CompileOptions& options, thread_pool& pool);
+		double compile(const std::vector<Interface::Color>& pixels, const uint16_t& width, const uint16_t& height, const CompileOptions& options, thread_pool& pool);
+
+		/* requantize
+		*  Converts a 32-bit texture to an indexed format in place, keeping the rest of its header. Mipmaps pass their texture as the parent
+		*  and are mapped onto its palette. Returns the mean error, or infinity if a mipmap cannot share its parent's format.
+		*/
+		double requantize(const CompileOptions& options, thread_pool& pool, Texture* parent = nullptr);
+	};
+
+	/* Requantization
+	*  Outcome of converting one 32-bit entry. error is the worst of its levels, and sizes count index and palette bytes.
+	*/
+	struct Requantization
+	{
+		bool	 converted{};
+		double	 error{};
+		uint32_t before{};
+		uint32_t after{};
 	};
 
 	class Entry : protected Interface::Logger
@@ -120,21 +188,27 @@ namespace tpl
 		void loadTexture(std::istream& stream);
 		void loadMipmaps(std::istream& stream);
 
-		void writeTextureHeader(std::ostream& stream, bool include_mips = true);
-		void writeTextureData(std::ostream& stream, bool include_mips = true);
+		void writeTextureHeader(ByteArray& file, const size_t& offset, bool include_mips = true);
+		void writeTextureData(ByteArray& file, bool include_mips = true);
 	public:
 		Entry(const Interface::Log& log) : Logger(&log), texture(log), mipmaps{ {log}, {log} } {}
 
 		void load(std::istream& stream);
 		void loadFromFile(const std::string& path);
 		void loadMipmapsFromFile(const std::string& path);
-		void saveTexture(std::ostream& stream, bool include_mips = true);
+		void saveTexture(ByteArray& file, const size_t& offset, bool include_mips = true);
 
 		Texture& getTexture();
 		Texture& getMipmap(const size_t& index);
 
 		bool hasMipmaps();
 		uint16_t getMipmapCount();
+		uint32_t getDataSize(bool include_mips = true);
+
+		/* requantize
+		*  Converts a 32-bit entry and its mipmaps to an indexed format. Nothing changes if the error exceeds maxError or nothing is saved.
+		*/
+		Requantization requantize(const CompileOptions& options, const double& maxError, thread_pool& pool);
 	};
 
 	class TplFile : protected Interface::Logger
@@ -153,12 +227,17 @@ namespace tpl
 		TplFile(const std::vector<tpl::Entry>& _entries, const Interface::Log& log) : Logger(&log), entries(_entries) {};
 
 		void load(const std::string& path);
-		void loadFromMemory(const ByteArray& data);
+		void loadFromMemory(ByteView data);
 
 		void save(const std::string& path, bool include_mips = true);
-		void calculateOffsets(bool include_mips = true);
-		void writeHeader(std::ostream& stream);
-		void writeEntries(std::ostream& stream, bool include_mips = true);
+		uint32_t calculateOffsets(bool include_mips = true);							// Returns the size of the file
+
+		/* serialize
+		*  Lays the whole file out in one zeroed buffer: headers, then index and palette blocks copied in place at their offsets.
+		*/
+		ByteArray serialize();
+		void writeHeader(ByteArray& file);
+		void writeEntries(ByteArray& file, bool include_mips = true);
 
 		TplFile& operator += (TplFile& rhs);
 		std::vector<tpl::Entry>& getEntries() { return entries; }
@@ -168,7 +247,14 @@ namespace tpl
 
 		void decompileAll(const std::string& path, bool include_mips = true);
 		void decompile(const size_t index, const std::string& path, bool include_mips = true);
-		void compile(const std::string& path);
+		bool compile(const std::string& path, const CompileOptions& options = {});
+
+		/* requantize
+		*  Converts the selected 32-bit entries (all of them when ranges is empty) side by side and recalculates the offsets.
+		*  Results are indexed like the entries; entries that were not attempted are left default.
+		*/
+		std::vector<Requantization> requantize(const CompileOptions& options, const double& maxError, thread_pool& pool, const std::vector<std::pair<size_t, size_t>>& ranges = {});
+		std::vector<Requantization> requantize(const CompileOptions& options, const double& maxError, const std::vector<std::pair<size_t, size_t>>& ranges = {});
 	};
 
 }
\ No newline at end of file